@@ -1 +1,2 @@
-option(NP_BUILD_TESTS "Build with tests." OFF)
\ No newline at end of file
+option(NP_BUILD_TESTS "Build with tests." OFF)
+option(NP_BUILD_CAPTURE_REPLAY "Build the capture replay command line tool." OFF)
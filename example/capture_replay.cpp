@@ -0,0 +1,153 @@
+/* capture_replay: converts frames recorded with `capture_write` and reports
+ * the time `convert_replay` takes for them.
+ *
+ *   capture_replay <capture file> [iterations]
+ *
+ * Fonts are replaced by a fixed width font of the captured height, so text
+ * costs about as much as with the original font. Images keep their handles. */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <nk/nuklear.hpp>
+
+namespace {
+  float
+  replay_font_width(const nk::resource_handle font, const float height, const char*, const int len) {
+    NK_UNUSED(font);
+    return (float) len * height * 0.5f;
+  }
+  void
+  replay_font_glyph(const nk::resource_handle font, const float height, nk::user_font_glyph* glyph,
+                    const nk::rune codepoint, const nk::rune next) {
+    NK_UNUSED(font);
+    NK_UNUSED(codepoint);
+    NK_UNUSED(next);
+    std::memset(glyph, 0, sizeof(*glyph));
+    glyph->width = height * 0.5f;
+    glyph->height = height;
+    glyph->xadvance = height * 0.5f;
+    glyph->uv[1] = nk::vec2f{1.0f, 1.0f};
+  }
+  void*
+  replay_alloc(nk::resource_handle, void* old, const std::size_t size) {
+    return std::realloc(old, size);
+  }
+  void
+  replay_free(nk::resource_handle, void* ptr) {
+    std::free(ptr);
+  }
+  bool
+  read_file(const char* path, std::vector<std::uint8_t>* data) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (!file)
+      return false;
+    std::uint8_t chunk[1 << 16];
+    std::size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+      data->insert(data->end(), chunk, chunk + read);
+    const bool ok = !std::ferror(file);
+    std::fclose(file);
+    return ok;
+  }
+}
+
+int
+main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <capture file> [iterations]\n", argv[0]);
+    return 1;
+  }
+  const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+  std::vector<std::uint8_t> data;
+  if (!read_file(argv[1], &data)) {
+    std::fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[1]);
+    return 1;
+  }
+
+  nk::allocator heap{};
+  heap.alloc = replay_alloc;
+  heap.free = replay_free;
+  nk::memory_buffer commands, cmds, vertices, elements;
+  nk::buffer_init(&commands, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  nk::buffer_init(&cmds, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  nk::buffer_init(&vertices, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  nk::buffer_init(&elements, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+
+  static const nk::draw_vertex_layout_element layout[] = {
+      {nk::NK_VERTEX_POSITION, nk::NK_FORMAT_FLOAT, 0},
+      {nk::NK_VERTEX_TEXCOORD, nk::NK_FORMAT_FLOAT, 8},
+      {nk::NK_VERTEX_COLOR, nk::NK_FORMAT_R8G8B8A8, 16},
+      {nk::NK_VERTEX_ATTRIBUTE_COUNT, nk::NK_FORMAT_COUNT, 0}};
+  nk::convert_config config{};
+  config.global_alpha = 1.0f;
+  config.line_AA = nk::NK_ANTI_ALIASING_ON;
+  config.shape_AA = nk::NK_ANTI_ALIASING_ON;
+  config.circle_segment_count = 22;
+  config.arc_segment_count = 22;
+  config.curve_segment_count = 22;
+  config.vertex_layout = layout;
+  config.vertex_size = 20;
+  config.vertex_alignment = alignof(float);
+
+  nk::draw_list list;
+  nk::draw_list_init(&list);
+  std::vector<nk::user_font> fonts;
+  std::vector<const nk::user_font*> bound;
+  std::size_t offset = 0, frames = 0, commands_total = 0, vertex_total = 0, element_total = 0;
+  double seconds = 0;
+  while (offset < data.size()) {
+    nk::capture_reader reader;
+    if (!nk::capture_reader_init(&reader, data.data() + offset, data.size() - offset)) {
+      std::fprintf(stderr, "%s: malformed frame at byte %zu\n", argv[0], offset);
+      return 1;
+    }
+    fonts.assign(reader.font_count, nk::user_font{});
+    bound.resize(reader.font_count);
+    for (unsigned int i = 0; i < reader.font_count; ++i) {
+      fonts[i].height = nk::capture_font_height(&reader, i);
+      fonts[i].width = replay_font_width;
+      fonts[i].query = replay_font_glyph;
+      bound[i] = &fonts[i];
+    }
+    nk::capture_bindings bindings{};
+    bindings.fonts = bound.data();
+    bindings.font_count = reader.font_count;
+    if (!nk::capture_replay(&reader, &bindings, &commands)) {
+      std::fprintf(stderr, "%s: cannot replay frame %zu\n", argv[0], frames);
+      return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      nk::buffer_clear(&cmds);
+      nk::buffer_clear(&vertices);
+      nk::buffer_clear(&elements);
+      if (nk::convert_replay(&list, &commands, &cmds, &vertices, &elements, &config) != nk::NK_CONVERT_SUCCESS) {
+        std::fprintf(stderr, "%s: cannot convert frame %zu\n", argv[0], frames);
+        return 1;
+      }
+    }
+    seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    commands_total += reader.command_count;
+    vertex_total += list.vertex_count;
+    element_total += list.element_count;
+    offset += reader.size;
+    frames++;
+  }
+  if (!frames) {
+    std::fprintf(stderr, "%s: %s contains no frames\n", argv[0], argv[1]);
+    return 1;
+  }
+  std::printf("%zu frames, %zu commands, %zu vertices, %zu elements per frame\n", frames,
+              commands_total / frames, vertex_total / frames, element_total / frames);
+  std::printf("convert_replay: %.3f us per frame over %d iterations\n",
+              seconds * 1e6 / (double) (frames * (std::size_t) iterations), iterations);
+
+  nk::buffer_free(&commands);
+  nk::buffer_free(&cmds);
+  nk::buffer_free(&vertices);
+  nk::buffer_free(&elements);
+  return 0;
+}
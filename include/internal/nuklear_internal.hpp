@@ -2,8 +2,12 @@
 #define INTERNAL_H
 
 #include <array>
+#include <atomic>
 #include <utility>
 #include <cstdint>
+#if defined(_MSC_VER) && !defined(__GNUC__) && !defined(__clang__)
+#include <intrin.h> /* _ReturnAddress for NK_RETURN_ADDRESS */
+#endif
 
 namespace nk {
 
@@ -72,6 +76,16 @@ namespace nk {
 #define NK_STATIC_ASSERT(exp) typedef char NK_UNIQUE_NAME(_dummy_array)[(exp) ? 1 : 0]
 #endif
 
+#ifndef NK_RETURN_ADDRESS
+#if defined(__GNUC__) || defined(__clang__)
+#define NK_RETURN_ADDRESS() __builtin_return_address(0)
+#elif defined(_MSC_VER)
+#define NK_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define NK_RETURN_ADDRESS() ((void*) 0)
+#endif
+#endif
+
 #ifndef NK_FILE_LINE
 #ifdef _MSC_VER
 #define NK_FILE_LINE __FILE__ ":" NK_STRINGIFY(__COUNTER__)
@@ -184,6 +198,25 @@ constexpr auto operator|=(T lhs, T rhs) -> T
 #ifndef NK_POOL_DEFAULT_CAPACITY
 #define NK_POOL_DEFAULT_CAPACITY 16
 #endif
+#ifndef NK_WINDOW_PAGE_CAPACITY
+#define NK_WINDOW_PAGE_CAPACITY NK_POOL_DEFAULT_CAPACITY /**< windows per pool page */
+#endif
+#ifndef NK_PANEL_PAGE_CAPACITY
+#define NK_PANEL_PAGE_CAPACITY NK_POOL_DEFAULT_CAPACITY /**< panels per pool page */
+#endif
+#ifndef NK_TABLE_PAGE_CAPACITY
+#define NK_TABLE_PAGE_CAPACITY NK_POOL_DEFAULT_CAPACITY /**< state tables per pool page */
+#endif
+
+#ifndef NK_OCCLUSION_MAX_OCCLUDERS
+#define NK_OCCLUSION_MAX_OCCLUDERS 16 /**< opaque rectangles tracked by occlusion culling */
+#endif
+
+#define NK_FRAME_SLOT_FRESH 4u /**< set on `frame_handoff::middle` after a publish */
+
+#ifndef NK_DAMAGE_MERGE_LIMIT
+#define NK_DAMAGE_MERGE_LIMIT 256 /**< more dirty rectangles than this are reported as their bounding box */
+#endif
 
 #ifndef NK_DEFAULT_COMMAND_BUFFER_SIZE
 #define NK_DEFAULT_COMMAND_BUFFER_SIZE (4 * 1024)
@@ -193,6 +226,10 @@ constexpr auto operator|=(T lhs, T rhs) -> T
 #define NK_BUFFER_DEFAULT_INITIAL_SIZE (4 * 1024)
 #endif
 
+#ifndef NK_BUFFER_HUGE_PAGE_SIZE
+#define NK_BUFFER_HUGE_PAGE_SIZE (2 * 1024 * 1024) /**< commit granularity of virtual buffers with huge pages */
+#endif
+
 /* standard library headers */
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
 #include <stdlib.h> /* malloc, free */
@@ -283,6 +320,9 @@ constexpr auto operator|=(T lhs, T rhs) -> T
   struct style_item;
   struct text_edit;
   struct draw_list;
+  struct draw_cache;
+  struct draw_batch;
+  struct convert_pool;
   struct user_font;
   struct panel;
   struct context;
@@ -398,7 +438,8 @@ constexpr auto operator|=(T lhs, T rhs) -> T
     NK_CONVERT_INVALID_PARAM = 1,
     NK_CONVERT_COMMAND_BUFFER_FULL = (1 << (1)),
     NK_CONVERT_VERTEX_BUFFER_FULL = (1 << (2)),
-    NK_CONVERT_ELEMENT_BUFFER_FULL = (1 << (3))
+    NK_CONVERT_ELEMENT_BUFFER_FULL = (1 << (3)),
+    NK_CONVERT_INSTANCE_BUFFER_FULL = (1 << (4))
   };
 
   typedef char glyph[NK_UTF_SIZE];
@@ -440,6 +481,9 @@ constexpr auto operator|=(T lhs, T rhs) -> T
     const draw_vertex_layout_element* vertex_layout; /**!< describes the vertex output format and packing */
     std::size_t vertex_size; /**!< sizeof one vertex for vertex packing */
     std::size_t vertex_alignment; /**!< vertex alignment: Can be obtained by NK_ALIGNOF */
+    struct draw_cache* cache; /**!< optional per window vertex cache to only convert changed windows or NULL */
+    struct draw_batch* batch; /**!< optional batching pass run on the converted draw commands or NULL */
+    bool pixel_snap; /**!< rounds edges of unrounded rectangles and axis aligned lines to whole pixels */
   };
 
   enum class style_item_type {
@@ -505,6 +549,15 @@ constexpr auto operator|=(T lhs, T rhs) -> T
       std::size_t calls;
     };
 
+    /** usage of one memory subsystem, all sizes are in bytes */
+    struct memory_usage {
+      std::size_t used; /**!< currently in use */
+      std::size_t peak; /**!< high-water mark of `used` */
+      std::size_t capacity; /**!< currently allocated or committed */
+      std::size_t calls; /**!< number of allocations */
+      std::size_t grows; /**!< number of times more memory had to be requested */
+    };
+
     typedef void* (*plugin_alloc)(resource_handle, void* old, std::size_t);
     typedef void (*plugin_free)(resource_handle, void* old);
     typedef bool (*plugin_filter)(const text_edit*, rune unicode);
@@ -513,7 +566,8 @@ constexpr auto operator|=(T lhs, T rhs) -> T
 
     enum class allocation_type {
       BUFFER_FIXED,
-      BUFFER_DYNAMIC
+      BUFFER_DYNAMIC,
+      BUFFER_VIRTUAL
     };
 
     enum class buffer_allocation_type {
@@ -539,6 +593,19 @@ constexpr auto operator|=(T lhs, T rhs) -> T
       plugin_free free;
     };
 
+    /** `site` is the code address inside the library the allocator was called from, `size` is zero for frees */
+    typedef void (*allocation_report_f)(resource_handle userdata, const void* site, void* memory, std::size_t size);
+
+    /** allocator wrapper counting every call made after warmup, see `allocation_guard_init` */
+    struct allocation_guard {
+      allocator parent; /**!< allocator all calls are forwarded to */
+      allocation_report_f report; /**!< called for each call while armed, asserts if not set */
+      resource_handle userdata;
+      bool armed;
+      std::size_t allocs; /**!< allocations since the guard was armed */
+      std::size_t frees; /**!< frees since the guard was armed */
+    };
+
     struct memory_buffer {
       std::array<buffer_marker, static_cast<unsigned>(buffer_allocation_type::BUFFER_MAX)> marker; /**!< buffer marker to free a buffer to a certain offset */
       allocator pool; /**!< allocator callback for dynamic buffers */
@@ -549,6 +616,10 @@ constexpr auto operator|=(T lhs, T rhs) -> T
       std::size_t needed; /**!< totally consumed memory given that enough memory is present */
       std::size_t calls; /**!< number of allocation calls */
       std::size_t size; /**!< current size of the buffer */
+      std::array<std::size_t, static_cast<unsigned>(buffer_allocation_type::BUFFER_MAX)> committed; /**!< committed bytes at the front and back of a virtual buffer */
+      std::size_t commit_size; /**!< commit granularity of a virtual buffer */
+      std::size_t peak; /**!< high-water mark of front and back allocations together */
+      std::size_t grows; /**!< number of reallocations or commits */
     };
     /*==============================================================
      *                          STACK
@@ -1441,6 +1512,7 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
     std::size_t last;
     std::size_t end;
     bool active;
+    bool linked; /**!< drawn behind all windows by the last `build`, `begin` to `last` is valid */
   };
 
   struct menu_state {
@@ -1485,6 +1557,9 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
    * =============================================================*/
 #ifndef NK_WINDOW_MAX_NAME
 #define NK_WINDOW_MAX_NAME 64
+#endif
+#ifndef NK_WINDOW_INDEX_SIZE
+#define NK_WINDOW_INDEX_SIZE 256 /**< number of window lookup slots, must be a power of two */
 #endif
 
   struct table;
@@ -1694,6 +1769,22 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
     rectf header;
   };
 
+  /** slot of the per window state index, refers to a value inside a table page */
+  struct value_slot {
+    table* tbl;
+    hash key;
+    unsigned int index;
+  };
+
+  /** open addressing index over all table pages of a window. Only built once
+   * a window needs more than one table page and only if the context has an
+   * allocator to grow it with, otherwise lookup walks the table pages. */
+  struct value_index {
+    value_slot* slots;
+    unsigned int capacity;
+    unsigned int count;
+  };
+
   struct edit_state {
     hash name;
     unsigned int seq;
@@ -1753,7 +1844,12 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
     unsigned int scrolled;
     bool widgets_disabled;
 
+    hash command_hash; /**!< fingerprint of the commands of the last built frame */
+    bool command_modified;
+
     table* tables;
+    table* table_sweep;
+    value_index values;
     unsigned int table_count;
 
     /* window list hooks */
@@ -1765,6 +1861,12 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
   /*==============================================================
    *                          CONTEXT
    * =============================================================*/
+#ifndef NK_VALUE_INDEX_MIN_CAPACITY
+#define NK_VALUE_INDEX_MIN_CAPACITY 256 /**< initial number of slots of a window state index, must be a power of two */
+#endif
+#ifndef NK_TABLE_SWEEP_BUDGET
+#define NK_TABLE_SWEEP_BUDGET 8 /**< number of table pages per window checked for aging on each `clear` */
+#endif
 #define NK_VALUE_PAGE_CAPACITY \
 (((std::max(sizeof(struct window), sizeof(struct panel)) / sizeof(std::uint32_t))) / 2)
 
@@ -1776,33 +1878,68 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
     table *next, *prev;
   };
 
-  union page_data {
-    table tbl;
-    panel pan;
-    window win;
+  enum class page_type {
+    PAGE_WINDOW,
+    PAGE_PANEL,
+    PAGE_TABLE,
+    PAGE_MAX
   };
 
+  /** unused window, panel or table, stored in place of the freed element */
   struct page_element {
-    page_data data;
     page_element* next;
-    page_element* prev;
   };
 
+  /** pool allocation holding elements of a single type, the elements follow the header */
   struct page {
-    unsigned int size;
     page* next;
-    page_element win[1];
+    unsigned int size; /**!< number of elements handed out from this page */
+  };
+
+  /** pages and unused elements of one element type */
+  struct slab {
+    page* pages;
+    page_element* freelist;
+    unsigned int page_count;
+    unsigned int count; /**!< number of elements in use */
+    unsigned int peak; /**!< most elements in use at once */
+    std::size_t calls; /**!< number of element allocations */
+    std::size_t grows; /**!< number of page allocations */
   };
 
   struct pool {
     allocator alloc;
     allocation_type type;
-    unsigned int page_count;
-    page* pages;
-    page_element* freelist;
-    unsigned capacity;
+    std::array<slab, static_cast<unsigned>(page_type::PAGE_MAX)> slabs;
+    void* memory; /**!< memory of a fixed pool, elements of all types are taken front to back */
     std::size_t size;
-    std::size_t cap;
+    std::size_t allocated;
+  };
+
+  struct pool_usage {
+    memory_usage memory;
+    unsigned int pages;
+    unsigned int elements; /**!< elements in use */
+    unsigned int free_elements; /**!< length of the free list */
+  };
+
+  /** snapshot of all memory owned by a context, see `memory_info` */
+  struct memory_stats {
+    memory_usage commands; /**!< draw command buffer, calls are counted per frame */
+    std::array<pool_usage, static_cast<unsigned>(page_type::PAGE_MAX)> pools; /**!< windows, panels and tables */
+    memory_usage text_edit; /**!< text edit string buffer */
+    memory_usage path; /**!< draw list path scratch of the last `convert` */
+    unsigned int windows;
+    unsigned int tables;
+    unsigned int max_window_tables; /**!< most state tables of a single window */
+  };
+
+  /** memory of a single window, see `window_memory_info` */
+  struct window_memory_stats {
+    unsigned int tables;
+    unsigned int values; /**!< stored state values */
+    std::size_t table_bytes;
+    std::size_t index_bytes; /**!< state value hash index */
   };
 
 
@@ -1896,6 +2033,21 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
    *     struct context ctx;
    *     init_default(&ctx, &font);
    * ```
+   *
+   * Clamping and wrapping text measures a string one glyph at a time. If your
+   * font can return the advance of a single codepoint cheaply you can set the
+   * optional `advance` callback, otherwise `width` is called for each glyph.
+   * Either way the measured width is the sum of the single glyph widths, so
+   * kerning between glyphs is not taken into account.
+   *
+   * ```c
+   *     float your_glyph_advance(handle handle, float height, rune codepoint)
+   *     {
+   *         your_font_type *type = handle.ptr;
+   *         return ...;
+   *     }
+   *     font.advance = your_glyph_advance;
+   * ```
    * # Using your own implementation with vertex buffer output
    *
    * While the first approach works fine if you don't want to use the optional
@@ -2013,27 +2165,81 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
 
   struct user_font_glyph;
   typedef float (*text_width_f)(resource_handle, float h, const char*, int len);
+  typedef float (*text_advance_f)(resource_handle, float h, rune codepoint);
   typedef void (*query_font_glyph_f)(resource_handle handle, float font_height,
                                      user_font_glyph* glyph,
                                      rune codepoint, rune next_codepoint);
 
 #if defined(NK_INCLUDE_VERTEX_BUFFER_OUTPUT) || defined(NK_INCLUDE_SOFTWARE_FONT)
+  struct draw_list;
+  /** writes one vertex at `dst` and returns the address of the next one */
+  typedef void* (*draw_vertex_writer)(void* dst, const struct draw_list* list,
+                                      vec2f pos, vec2f uv, struct colorf color);
+
+#ifndef NK_DRAW_VERTEX_BLOCK
+#define NK_DRAW_VERTEX_BLOCK 64 /**< tessellated vertices staged before one call packs them into the vertex buffer */
+#endif
+
+  /** one tessellated vertex before it is packed into the vertex layout */
+  struct draw_vertex_input {
+    vec2f pos;
+    vec2f uv;
+    struct colorf color;
+  };
+  /** writes `count` vertices at `dst` and returns the address after the last one */
+  typedef void* (*draw_vertex_block_writer)(void* dst, const struct draw_list* list,
+                                            const struct draw_vertex_input* src, unsigned int count);
+
+#ifndef NK_DRAW_ARC_CACHE_SIZE
+#define NK_DRAW_ARC_CACHE_SIZE 16 /**< number of tessellated unit arcs kept per context and convert worker */
+#endif
+#ifndef NK_DRAW_ARC_CACHE_POINTS
+#define NK_DRAW_ARC_CACHE_POINTS 256 /**< points shared by all cached unit arcs */
+#endif
+#ifndef NK_CIRCLE_MAX_ERROR
+#define NK_CIRCLE_MAX_ERROR 0.3f /**< largest distance in pixels between a circle and its tessellation */
+#endif
+
+  struct draw_arc_entry {
+    float a_min;
+    float a_max;
+    unsigned int offset; /**!< first point in `draw_arc_cache::points` */
+    unsigned int count; /**!< segments + 1 or 0 if unused */
+  };
+
+  /** unit arcs of `draw_list_path_arc_to` so repeated shapes only need a scale and translate */
+  struct draw_arc_cache {
+    struct draw_arc_entry entries[NK_DRAW_ARC_CACHE_SIZE];
+    vec2f points[NK_DRAW_ARC_CACHE_POINTS];
+    unsigned int used;
+  };
+
   struct draw_list {
     rectf clip_rect;
     vec2f circle_vtx[12];
+    struct draw_arc_cache* arcs; /**!< optional, owned by the context or worker so copies of the list stay small */
     struct convert_config config;
+    draw_vertex_block_writer block_writer; /**!< packs staged vertices, selected from the vertex layout in `draw_list_setup` */
+    draw_vertex_writer vertex_writer; /**!< per vertex writer of `convert_with_writer` called by `block_writer` */
+    std::size_t position_offset; /**!< attribute offsets used by the specialized writers */
+    std::size_t texcoord_offset;
+    std::size_t color_offset;
 
     memory_buffer* buffer;
     memory_buffer* vertices;
     memory_buffer* elements;
+    memory_buffer* instances; /**!< instance output of `convert_instanced` or NULL */
 
     unsigned int element_count;
     unsigned int vertex_count;
+    unsigned int instance_count;
+    unsigned int vertex_base; /**!< `vertex_offset` of the last draw command */
     unsigned int cmd_count;
     std::size_t cmd_offset;
 
     unsigned int path_count;
     unsigned int path_offset;
+    unsigned int path_peak; /**!< most path points used at once */
 
     enum anti_aliasing line_AA;
     enum anti_aliasing shape_AA;
@@ -2044,6 +2250,68 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
 #endif
   };
 
+  /** converted output of one window, offsets point into the cache frame buffers */
+  struct draw_cache_entry {
+    hash name; /**!< window name hash */
+    hash commands; /**!< window command stream hash the output was converted from */
+    std::size_t vertex_offset;
+    std::size_t element_offset;
+    std::size_t command_offset;
+    unsigned int vertex_count;
+    unsigned int element_count; /**!< elements are stored relative to the first window vertex */
+    unsigned int command_count;
+  };
+
+  struct draw_cache_frame {
+    memory_buffer entries;
+    memory_buffer vertices;
+    memory_buffer elements;
+    memory_buffer commands;
+    unsigned int entry_count;
+  };
+
+  /** keeps the converted vertices of each window of the last `convert` call
+   * so unchanged windows only have to be copied instead of tessellated again */
+  struct draw_cache {
+    struct draw_cache_frame frames[2];
+    unsigned int current;
+    hash config; /**!< hash of the convert configuration the cache was filled with */
+  };
+
+  /** bytes a frame needs in each buffer, see `convert_measure` */
+  struct convert_requirements {
+    std::size_t commands; /**!< vertex draw command buffer of `convert` */
+    std::size_t vertices; /**!< vertex buffer including temporary tessellation memory */
+    std::size_t elements;
+    std::size_t memory; /**!< context command buffer at the end of the frame */
+  };
+
+  struct convert_planner {
+    memory_buffer commands; /**!< scratch output of the measuring pass */
+    memory_buffer vertices;
+    memory_buffer elements;
+    struct convert_requirements frame; /**!< last measured frame */
+    struct convert_requirements envelope; /**!< worst case of all measured frames */
+    unsigned int frames; /**!< number of frames in the envelope */
+  };
+
+  /** resume token of a chunked conversion, see `convert_stream_next` */
+  struct convert_stream {
+    std::size_t offset; /**!< context command the next chunk starts with */
+    rectf clip_rect; /**!< draw state the next chunk continues with */
+    resource_handle texture;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    resource_handle userdata;
+#endif
+    unsigned int chunks; /**!< number of completed chunks */
+    bool done; /**!< all commands of the frame were converted */
+  };
+
+  /** receives a full chunk, the output buffers are cleared and reused after it returns */
+  typedef void (*convert_flush_f)(resource_handle userdata, const struct draw_list* list,
+                                  const memory_buffer* cmds, const memory_buffer* vertices,
+                                  const memory_buffer* elements);
+
   struct user_font_glyph {
     vec2f uv[2]; /**!< texture coordinates */
     vec2f offset; /**!< offset between top left and glyph */
@@ -2052,6 +2320,116 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
   };
 #endif
 
+  /** one visible draw command as seen by `frame_damage` */
+  struct damage_entry {
+    hash key; /**!< payload, scissor and window layer of the command */
+    rectf bounds; /**!< clipped screen area the command can touch */
+  };
+
+  /** draw commands of the previous frame to compute dirty rectangles from */
+  struct damage_tracker {
+    memory_buffer entries[2]; /**!< `damage_entry` sorted by key */
+    unsigned int counts[2];
+    unsigned int current; /**!< entries of the last frame */
+    memory_buffer rects; /**!< scratch dirty rectangles */
+    bool valid; /**!< a previous frame was recorded */
+  };
+
+  /** binary format version written by `capture_write` */
+#define NK_CAPTURE_VERSION 1
+
+  /** scratch handle tables of `capture_write` */
+  struct capture_writer {
+    memory_buffer fonts; /**!< `user_font` pointers in first use order */
+    memory_buffer images; /**!< image handles in first use order */
+  };
+
+  /** view into one captured frame, points into the memory passed to `capture_reader_init` */
+  struct capture_reader {
+    const std::uint8_t* data;
+    std::size_t size; /**!< bytes of this frame, the next frame starts behind it */
+    unsigned int flags;
+    unsigned int command_count;
+    unsigned int font_count;
+    unsigned int image_count;
+    std::size_t records; /**!< offsets of the sections relative to `data` */
+    std::size_t fonts;
+    std::size_t images;
+  };
+
+  /** replacements for the font and image handle tables of a capture */
+  struct capture_bindings {
+    const user_font* const* fonts; /**!< text with unbound fonts is dropped */
+    unsigned int font_count;
+    const resource_handle* images; /**!< unbound images keep the captured handle */
+    unsigned int image_count;
+  };
+
+  /** serialized commands of one window inside a stream frame */
+  struct stream_window {
+    hash name; /**!< window name hash, the popup name hashed with its window name for popups, zero for the overlay */
+    std::size_t offset; /**!< first record inside the frame records */
+    std::size_t size;
+    unsigned int count; /**!< number of records */
+  };
+
+  /** per window records of the last two frames of a stream */
+  struct stream_frame {
+    memory_buffer records;
+    memory_buffer windows; /**!< `stream_window` in drawing order */
+    unsigned int window_count;
+    unsigned int command_count;
+  };
+
+  /** sends frames as differences to the previous frame, see `stream_encode` */
+  struct stream_encoder {
+    struct capture_writer tables; /**!< font and image tables shared by all frames since the last key frame */
+    std::uint32_t fonts_sent;
+    std::uint32_t images_sent;
+    struct stream_frame frames[2];
+    memory_buffer scratch; /**!< record offsets while diffing a window */
+    unsigned int current;
+    unsigned int frame; /**!< number of encoded frames */
+    bool valid; /**!< false until the first key frame was encoded */
+  };
+
+  /** rebuilds frames from the messages of a `stream_encoder` */
+  struct stream_decoder {
+    memory_buffer fonts; /**!< encoded font table entries since the last key frame */
+    memory_buffer images; /**!< encoded image table entries */
+    struct stream_frame frames[2];
+    memory_buffer capture; /**!< rebuilt frame in capture format */
+    unsigned int current;
+    std::uint32_t frame; /**!< frame counter of the last decoded message */
+    bool valid; /**!< a key frame was decoded */
+  };
+
+  /** immutable copy of the command list of one frame, see `frame_publish` */
+  struct frame_slot {
+    memory_buffer commands; /**!< commands linked from the start of the buffer like `capture_replay` output */
+    unsigned int frame; /**!< number of the published frame */
+    unsigned int command_count;
+  };
+
+  /** triple buffer handing frames from the UI thread to a render thread */
+  struct frame_handoff {
+    struct frame_slot slots[3];
+    unsigned int back; /**!< slot written by the UI thread */
+    unsigned int front; /**!< slot read by the render thread */
+    std::atomic<unsigned int> middle; /**!< slot in between, `NK_FRAME_SLOT_FRESH` if not read yet */
+    unsigned int frame; /**!< number of published frames, UI thread only */
+    bool has_front; /**!< the render thread acquired a frame, render thread only */
+  };
+
+  /** open addressing index over all windows inside the window list, keyed by
+   * window name hash. Windows that do not fit below the maximum load factor are
+   * counted in `overflow` and only found by walking the list. */
+  struct window_index {
+    window* slots[NK_WINDOW_INDEX_SIZE];
+    unsigned int count;
+    unsigned int overflow;
+  };
+
   struct context {
     /* public: can be accessed freely */
     input input;
@@ -2067,6 +2445,7 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
         know what you are doing */
 #ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
     struct draw_list draw_list;
+    struct draw_arc_cache arcs; /**!< unit arcs of `draw_list` */
 #endif
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     resource_handle userdata;
@@ -2087,15 +2466,26 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
     window* end;
     window* active;
     window* current;
-    page_element* freelist;
+    struct window_index window_index;
     unsigned int count;
     unsigned int seq;
+
+    /** fingerprint of all commands of the last built frame */
+    hash frame_hash;
+    bool frame_modified;
+
+    /** drop commands hidden below opaque windows in `build` */
+    bool occlusion_culling;
+    float occlusion_alpha; /**!< `convert_config::global_alpha` the frames are converted with */
+    unsigned int culled_commands; /**!< commands dropped by the last build */
+    unsigned int culled_windows; /**!< windows dropped completely by the last build */
   };
 
   struct user_font {
     resource_handle userdata; /**!< user provided font handle */
     float height; /**!< max height of the font */
     text_width_f width; /**!< font string width in pixel callback */
+    text_advance_f advance; /**!< optional single glyph advance callback used for incremental text measuring */
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     query_font_glyph_f query;
     resource_handle texture;
@@ -2109,16 +2499,78 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
       std::size_t offset;
     };
 
+    /** one rectangle, rounded rectangle, border, image or glyph quad of `convert_instanced` */
+    struct draw_instance {
+      rectf rect; /**< screen rectangle */
+      vec2f uv[2]; /**< texture coordinates of the top left and bottom right corner */
+      float rounding; /**< corner radius, at most half the smaller rectangle extent */
+      float thickness; /**< border thickness centered on the rectangle edge or 0 to fill */
+      struct color color; /**< multiplied with the texture sample */
+    };
+
     struct draw_command {
       unsigned int elem_count; /**< number of elements in the current draw batch */
       rectf clip_rect; /**< current screen clipping rectangle */
       resource_handle texture; /**< current texture to set */
+      unsigned int vertex_offset; /**< base vertex added to every element of this batch */
+      unsigned int instance_count; /**< number of `draw_instance` records of this batch, it has no elements then */
 
 #ifdef NK_INCLUDE_COMMAND_USERDATA
       resource_handle userdata;
 #endif
     };
 
+#ifndef NK_CONVERT_MAX_WORKERS
+#define NK_CONVERT_MAX_WORKERS 16
+#endif
+
+  /** runs `task(data, i)` for every `i` in `[0, count)` and returns after all calls finished */
+  typedef void (*convert_task_f)(void* data, int index);
+  typedef void (*plugin_dispatch)(resource_handle, convert_task_f task, void* data, int count);
+
+  /** linked command range of one window or of all popups and the overlay */
+  struct convert_segment {
+    std::size_t begin;
+    std::size_t last;
+    std::size_t size; /**!< command memory size used to balance work between workers */
+  };
+
+  struct convert_worker {
+    struct draw_list list;
+    struct draw_arc_cache arcs; /**!< unit arcs of `list` */
+    memory_buffer cmds;
+    memory_buffer vertices;
+    memory_buffer elements;
+    unsigned int first; /**!< index of the first converted segment */
+    unsigned int count; /**!< number of converted segments */
+    struct draw_command seed; /**!< predicted last draw command of the previous segment */
+    bool seed_elements;
+    bool valid;
+  };
+
+  /** scratch state for `convert_parallel`, every worker converts a contiguous
+   * run of segments into its own buffers which are joined afterwards */
+  struct convert_workers {
+    allocator alloc;
+    plugin_dispatch dispatch; /**!< optional user task dispatcher, `pool` is used if NULL */
+    resource_handle userdata; /**!< passed to `dispatch` */
+    struct convert_pool* pool; /**!< persistent threads used if `dispatch` is NULL */
+    memory_buffer segments;
+    int count;
+    struct convert_worker worker[NK_CONVERT_MAX_WORKERS];
+  };
+
+#ifndef NK_DRAW_BATCH_LOOKBACK
+#define NK_DRAW_BATCH_LOOKBACK 32 /**< earlier draw commands a command may be merged into */
+#endif
+
+  /** scratch state and counters of the draw command batching pass, see `draw_list_batch` */
+  struct draw_batch {
+    memory_buffer scratch;
+    unsigned int commands_before; /**!< draw commands produced by the last conversion */
+    unsigned int commands_after; /**!< draw commands left after batching */
+  };
+
 #endif
 
 #ifdef NK_INCLUDE_FONT_BAKING
@@ -2165,6 +2617,26 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
     float u0, v0, u1, v1;
   };
 
+#ifndef NK_FONT_LOOKUP_PAGE_BITS
+#define NK_FONT_LOOKUP_PAGE_BITS 8
+#endif
+#define NK_FONT_LOOKUP_PAGE_SIZE (1u << NK_FONT_LOOKUP_PAGE_BITS)
+#define NK_FONT_LOOKUP_PAGE_COUNT (0x10000u >> NK_FONT_LOOKUP_PAGE_BITS)
+
+  struct font_glyph_range {
+    rune first, last; /**!< inclusive codepoint range */
+    rune glyph; /**!< index of the glyph of `first` inside the font glyph array */
+  };
+
+  /** glyph index built by `font_atlas_end` to resolve codepoints in constant time */
+  struct font_glyph_lookup {
+    unsigned short directory[NK_FONT_LOOKUP_PAGE_COUNT]; /**!< page number + 1 of each basic multilingual plane page or 0 if it holds no glyphs */
+    rune* pages; /**!< glyph index + 1 for each codepoint of each used page or 0 if the glyph is missing */
+    struct font_glyph_range* ranges; /**!< ranges above the basic multilingual plane sorted by first codepoint */
+    int range_count;
+    bool overlapping; /**!< ranges above the plane overlap and are searched linearly so the first match wins */
+  };
+
   struct font {
     struct font* next;
     struct user_font handle;
@@ -2175,6 +2647,7 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
     rune fallback_codepoint;
     resource_handle texture;
     font_config* config;
+    struct font_glyph_lookup* lookup;
   };
 
   enum font_atlas_format {
@@ -2199,6 +2672,9 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
     font* fonts;
     font_config* config;
     int font_num;
+
+    std::size_t temporary_peak; /**!< most temporary memory held at once while baking */
+    std::size_t temporary_calls;
   };
 
   /** some language glyph codepoint ranges */
@@ -2228,6 +2704,7 @@ NK_STATIC_ASSERT(sizeof(std::byte) == 1);
   NK_API void font_atlas_end(struct font_atlas*, resource_handle tex, struct draw_null_texture*);
   NK_API const struct font_glyph* font_find_glyph(const struct font*, rune unicode);
   NK_API void font_atlas_cleanup(struct font_atlas* atlas);
+  NK_API void font_atlas_info(struct memory_usage*, const struct font_atlas*);
   NK_API void font_atlas_clear(struct font_atlas*);
 
 #endif
@@ -216,6 +216,8 @@ namespace nk {
    * // draw
    * draw_foreach(cmd, &ctx, &cmds) {
    * if (!cmd->elem_count) continue;
+   *     // with 16-bit `draw_index` add `cmd->vertex_offset` to every index,
+   *     // e.g. as base vertex of glDrawElementsBaseVertex
    *     //[...]
    * }
    * buffer_free(&cms);
@@ -229,6 +231,7 @@ namespace nk {
    * \ref _begin       | Returns the first draw command in the context draw command list to be drawn
    * \ref _next        | Increments the draw command iterator to the next command inside the context draw command list
    * \ref foreach      | Iterates over each draw command inside the context draw command list
+   * \ref frame_changed | Returns if the draw command list changed since the previous frame
    * \ref convert      | Converts from the abstract draw commands list into a hardware accessible vertex format
    * \ref draw_begin   | Returns the first vertex command in the context vertex draw list to be executed
    * \ref _draw_next   | Increments the vertex command iterator to the next command inside the context vertex command list
@@ -1,6 +1,8 @@
 #ifndef NK_POWER_GUI_HPP
 #define NK_POWER_GUI_HPP
 
+#include <algorithm>
+#include <cstring>
 #include <internal/nuklear_internal.hpp>
 
 namespace nk {
@@ -74,40 +76,100 @@ namespace nk {
 
 #define NK_VERTEX_LAYOUT_END NK_VERTEX_ATTRIBUTE_COUNT, NK_FORMAT_COUNT, 0
 
+  /**
+   * Compile-time description of a vertex with a 2D float position, a 2D float
+   * texture coordinate and a color. Passed to the templated `convert` so each
+   * vertex is written with straight-line stores instead of walking the
+   * `draw_vertex_layout_element` array. Offsets and size are in bytes.
+   */
+  template <std::size_t Size, std::size_t Position, std::size_t Texcoord, std::size_t Color,
+            enum draw_vertex_layout_format ColorFormat = NK_FORMAT_R8G8B8A8>
+  struct draw_vertex_layout_desc {
+    static constexpr std::size_t size = Size;
+    static constexpr std::size_t position = Position;
+    static constexpr std::size_t texcoord = Texcoord;
+    static constexpr std::size_t color = Color;
+    static constexpr enum draw_vertex_layout_format color_format = ColorFormat;
+  };
+  /** `{float pos[2]; float uv[2]; std::uint8_t col[4];}` as used by most backends */
+  typedef draw_vertex_layout_desc<20, 0, 8, 16> draw_vertex_layout_pos2f_uv2f_rgba8;
+
+  template <enum draw_vertex_layout_format Format>
+  inline void
+  draw_vertex_write_color(void* dst, struct colorf color) {
+    static_assert(Format == NK_FORMAT_R8G8B8A8 || Format == NK_FORMAT_R8G8B8 ||
+                      Format == NK_FORMAT_B8G8R8A8 || Format == NK_FORMAT_R32G32B32A32_FLOAT,
+                  "no specialized writer for this color format");
+    if constexpr (Format == NK_FORMAT_R32G32B32A32_FLOAT) {
+      const float col[4] = {NK_SATURATE(color.r), NK_SATURATE(color.g),
+                            NK_SATURATE(color.b), NK_SATURATE(color.a)};
+      std::memcpy(dst, col, sizeof(col));
+    } else {
+      const std::uint8_t r = (std::uint8_t) (NK_SATURATE(color.r) * 255.0f);
+      const std::uint8_t g = (std::uint8_t) (NK_SATURATE(color.g) * 255.0f);
+      const std::uint8_t b = (std::uint8_t) (NK_SATURATE(color.b) * 255.0f);
+      const std::uint8_t a = (std::uint8_t) (NK_SATURATE(color.a) * 255.0f);
+      /* R8G8B8 keeps writing four bytes like the generic layout path */
+      if constexpr (Format == NK_FORMAT_B8G8R8A8) {
+        const std::uint8_t col[4] = {b, g, r, a};
+        std::memcpy(dst, col, sizeof(col));
+      } else {
+        const std::uint8_t col[4] = {r, g, b, a};
+        std::memcpy(dst, col, sizeof(col));
+      }
+    }
+  }
+  template <class Layout>
+  inline void*
+  draw_vertex_write(void* dst, const struct draw_list*, vec2f pos, vec2f uv, struct colorf color) {
+    std::byte* vtx = (std::byte*) dst;
+    std::memcpy(vtx + Layout::position, &pos, sizeof(pos));
+    std::memcpy(vtx + Layout::texcoord, &uv, sizeof(uv));
+    draw_vertex_write_color<Layout::color_format>(vtx + Layout::color, color);
+    return vtx + Layout::size;
+  }
+  template <class Layout>
+  inline void*
+  draw_vertex_write_block(void* dst, const struct draw_list* list, const struct draw_vertex_input* src, unsigned int count) {
+    for (unsigned int i = 0; i < count; ++i)
+      dst = draw_vertex_write<Layout>(dst, list, src[i].pos, src[i].uv, src[i].color);
+    return dst;
+  }
+
   /* draw list */
   NK_API void draw_list_init(struct draw_list*);
-  NK_API void draw_list_setup(struct draw_list*, const struct convert_config*, struct buffer* cmds, struct buffer* vertices, struct buffer* elements, enum anti_aliasing line_aa, enum anti_aliasing shape_aa);
+  NK_API void draw_list_setup(struct draw_list*, const struct convert_config*, memory_buffer* cmds, memory_buffer* vertices, memory_buffer* elements, enum anti_aliasing line_aa, enum anti_aliasing shape_aa);
 
   /* drawing */
 #define draw_list_foreach(cmd, can, b) for ((cmd) = _draw_list_begin(can, b); (cmd) != 0; (cmd) = _draw_list_next(cmd, b, can))
-  NK_API const struct draw_command* _draw_list_begin(const struct draw_list*, const struct buffer*);
-  NK_API const struct draw_command* _draw_list_next(const struct draw_command*, const struct buffer*, const struct draw_list*);
-  NK_API const struct draw_command* _draw_list_end(const struct draw_list*, const struct buffer*);
+  NK_API const struct draw_command* _draw_list_begin(const struct draw_list*, const memory_buffer*);
+  NK_API const struct draw_command* _draw_list_next(const struct draw_command*, const memory_buffer*, const struct draw_list*);
+  NK_API const struct draw_command* _draw_list_end(const struct draw_list*, const memory_buffer*);
 
   /* path */
   NK_API void draw_list_path_clear(struct draw_list*);
-  NK_API void draw_list_path_line_to(struct draw_list*, struct vec2 pos);
-  NK_API void draw_list_path_arc_to_fast(struct draw_list*, struct vec2 center, float radius, int a_min, int a_max);
-  NK_API void draw_list_path_arc_to(struct draw_list*, struct vec2 center, float radius, float a_min, float a_max, unsigned int segments);
-  NK_API void draw_list_path_rect_to(struct draw_list*, struct vec2 a, struct vec2 b, float rounding);
-  NK_API void draw_list_path_curve_to(struct draw_list*, struct vec2 p2, struct vec2 p3, struct vec2 p4, unsigned int num_segments);
+  NK_API void draw_list_path_line_to(struct draw_list*, vec2f pos);
+  NK_API void draw_list_path_arc_to_fast(struct draw_list*, vec2f center, float radius, int a_min, int a_max);
+  NK_API void draw_list_path_arc_to(struct draw_list*, vec2f center, float radius, float a_min, float a_max, unsigned int segments);
+  NK_API void draw_list_path_rect_to(struct draw_list*, vec2f a, vec2f b, float rounding);
+  NK_API void draw_list_path_curve_to(struct draw_list*, vec2f p2, vec2f p3, vec2f p4, unsigned int num_segments);
   NK_API void draw_list_path_fill(struct draw_list*, struct color);
   NK_API void draw_list_path_stroke(struct draw_list*, struct color, enum draw_list_stroke closed, float thickness);
 
   /* stroke */
-  NK_API void draw_list_stroke_line(struct draw_list*, struct vec2 a, struct vec2 b, struct color, float thickness);
+  NK_API void draw_list_stroke_line(struct draw_list*, vec2f a, vec2f b, struct color, float thickness);
   NK_API void draw_list_stroke_rect(struct draw_list*, struct rect rect, struct color, float rounding, float thickness);
-  NK_API void draw_list_stroke_triangle(struct draw_list*, struct vec2 a, struct vec2 b, struct vec2 c, struct color, float thickness);
-  NK_API void draw_list_stroke_circle(struct draw_list*, struct vec2 center, float radius, struct color, unsigned int segs, float thickness);
-  NK_API void draw_list_stroke_curve(struct draw_list*, struct vec2 p0, struct vec2 cp0, struct vec2 cp1, struct vec2 p1, struct color, unsigned int segments, float thickness);
-  NK_API void draw_list_stroke_poly_line(struct draw_list*, const struct vec2* pnts, const unsigned int cnt, struct color, enum draw_list_stroke, float thickness, enum anti_aliasing);
+  NK_API void draw_list_stroke_triangle(struct draw_list*, vec2f a, vec2f b, vec2f c, struct color, float thickness);
+  NK_API void draw_list_stroke_circle(struct draw_list*, vec2f center, float radius, struct color, unsigned int segs, float thickness);
+  NK_API void draw_list_stroke_curve(struct draw_list*, vec2f p0, vec2f cp0, vec2f cp1, vec2f p1, struct color, unsigned int segments, float thickness);
+  NK_API void draw_list_stroke_poly_line(struct draw_list*, const vec2f* pnts, const unsigned int cnt, struct color, enum draw_list_stroke, float thickness, enum anti_aliasing);
 
   /* fill */
   NK_API void draw_list_fill_rect(struct draw_list*, struct rect rect, struct color, float rounding);
   NK_API void draw_list_fill_rect_multi_color(struct draw_list*, struct rect rect, struct color left, struct color top, struct color right, struct color bottom);
-  NK_API void draw_list_fill_triangle(struct draw_list*, struct vec2 a, struct vec2 b, struct vec2 c, struct color);
-  NK_API void draw_list_fill_circle(struct draw_list*, struct vec2 center, float radius, struct color col, unsigned int segs);
-  NK_API void draw_list_fill_poly_convex(struct draw_list*, const struct vec2* points, const unsigned int count, struct color, enum anti_aliasing);
+  NK_API void draw_list_fill_triangle(struct draw_list*, vec2f a, vec2f b, vec2f c, struct color);
+  NK_API void draw_list_fill_circle(struct draw_list*, vec2f center, float radius, struct color col, unsigned int segs);
+  NK_API void draw_list_fill_poly_convex(struct draw_list*, const vec2f* points, const unsigned int count, struct color, enum anti_aliasing);
 
   /* misc */
   NK_API void draw_list_add_image(struct draw_list*, struct image texture, struct rect rect, struct color);
@@ -282,6 +344,65 @@ namespace nk {
    */
   NK_API void free(context*);
 
+  /**
+   * \brief Returns pool pages without any window, panel or table in use back to the allocator.
+   *
+   * \details
+   * Pages are kept for reuse once allocated, so a burst of windows or
+   * nested groups keeps its memory. Call this afterwards, for example when a
+   * large dialog was closed, to release it. Does nothing for fixed memory.
+   *
+   * ```c
+   * void trim(struct context *ctx);
+   * ```
+   *
+   * \param[in] ctx  Must point to a previously initialized `context` struct
+   */
+  NK_API void trim(context*);
+
+  /**
+   * \brief Takes a snapshot of all memory used by the context.
+   *
+   * \details
+   * Covers the draw command buffer, the window, panel and table pools, the
+   * text edit buffer and the draw list path scratch memory. Use it to export
+   * metrics or to size the memory of `init_fixed` and `init_custom`. Font atlas
+   * memory is reported by `font_atlas_info`.
+   *
+   * ```c
+   * void memory_info(struct memory_stats *stats, const struct context *ctx);
+   * ```
+   *
+   * \param[out] stats Must point to a `memory_stats` struct to fill out
+   * \param[in] ctx    Must point to a previously initialized `context` struct
+   */
+  NK_API void memory_info(struct memory_stats*, const context*);
+
+  /**
+   * \brief Drops draw commands hidden below opaque windows when the frame is built
+   *
+   * \details
+   * Unrounded filled rectangles without transparency, like window headers and
+   * the default color background, make a window opaque. Windows completely
+   * covered by the opaque area of a window above them are skipped and single
+   * commands inside covered areas are turned into `COMMAND_NOP`. Image and
+   * nine-slice backgrounds never hide anything and custom commands are always
+   * kept. `context::culled_windows` and `context::culled_commands` count what
+   * the last frame dropped. Off by default.
+   *
+   * `convert` multiplies every alpha with `convert_config::global_alpha`, so no
+   * window is opaque and nothing is culled while it is below 1.
+   *
+   * ```c
+   * void set_occlusion_culling(struct context *ctx, bool enable, float global_alpha);
+   * ```
+   *
+   * \param[in] ctx          Must point to a previously initialized `context` struct
+   * \param[in] enable       Enables culling from the next built frame on
+   * \param[in] global_alpha Must match `convert_config::global_alpha` of the conversion
+   */
+  NK_API void set_occlusion_culling(context*, bool enable, float global_alpha);
+
 #ifdef NK_INCLUDE_COMMAND_USERDATA
   /**
    * \brief Sets the currently passed userdata passed down into each draw command.
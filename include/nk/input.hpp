@@ -2,6 +2,7 @@
 #define NK_POWER_INPUT_HPP
 
 #include <internal/nuklear_internal.hpp>
+#include <nk/gui.hpp>
 
 namespace nk {
   /**
@@ -184,6 +185,240 @@ namespace nk {
    */
 #define foreach(c, ctx) for ((c) = _begin(ctx); (c) != 0; (c) = _next(ctx, c))
 
+  /**
+   * \brief Returns if the draw command list of this frame differs from the one of the previous frame
+   *
+   * \details
+   * Compares a hash over the payload of all visible draw commands, so renderers
+   * can skip `convert` and presentation for frames without any visual change.
+   * Command memory is not cleared by default, so padding bytes inside commands
+   * can report a frame as changed although nothing changed. Define
+   * `NK_ZERO_COMMAND_MEMORY` for exact results.
+   *
+   * ```c
+   * bool frame_changed(struct context*);
+   * ```
+   *
+   * \param[in] ctx     | Must point to an previously initialized `context` struct at the end of a frame
+   *
+   * \returns `true(1)` if any draw command changed or `false(0)` if the frame is identical to the previous one
+   */
+  NK_API bool frame_changed(context*);
+
+  /**
+   * \brief Initializes state to compute the screen areas that changed between two frames
+   *
+   * \details
+   * `frame_damage` records the bounds and payload of every visible draw command.
+   * Commands that exist in only one of two consecutive frames mark their bounds
+   * dirty, which covers commands that were added, removed, moved or changed and
+   * windows that changed their stacking order. The dirty areas are merged into at
+   * most `max` rectangles, so backends only have to clear, rasterize and transmit
+   * these. Like `frame_changed`, uninitialized padding inside commands can mark
+   * unchanged commands dirty without `NK_ZERO_COMMAND_MEMORY`.
+   *
+   * ```c
+   * damage_tracker_init(&damage, &alloc);
+   * // every frame after all windows were drawn
+   * int n = frame_damage(&ctx, &damage, rects, NK_LEN(rects));
+   * if (n < 0)
+   *     // redraw everything
+   * ```
+   *
+   * \param[in] tracker | Must point to a `damage_tracker` struct to initialize
+   * \param[in] alloc   | Allocator used for the recorded commands
+   */
+  NK_API void damage_tracker_init(struct damage_tracker*, const struct allocator*);
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+  NK_API void damage_tracker_init_default(struct damage_tracker*);
+#endif
+  /** \brief Forgets the previous frame so the next `frame_damage` reports a full redraw */
+  NK_API void damage_tracker_clear(struct damage_tracker*);
+  /** \brief Frees all memory held by the tracker */
+  NK_API void damage_tracker_free(struct damage_tracker*);
+
+  /**
+   * \brief Computes the dirty rectangles of this frame compared to the previous call
+   *
+   * \details
+   * Must be called once per frame after all windows were drawn and before `clear`.
+   *
+   * \param[in] ctx     | Must point to an previously initialized `context` struct at the end of a frame
+   * \param[in] tracker | Must point to a previously initialized `damage_tracker`
+   * \param[out] rects  | Receives up to `max` dirty rectangles
+   * \param[in] max     | Capacity of `rects`, at least one
+   *
+   * \returns the number of rectangles written, zero if nothing changed, or `-1` if
+   * the whole screen has to be redrawn because there is no previous frame or memory ran out
+   */
+  NK_API int frame_damage(context*, struct damage_tracker*, rectf* rects, int max);
+
+  /**
+   * \brief Initializes scratch state to serialize the command list
+   *
+   * \details
+   * `capture_write` appends the commands walked by `_begin` / `_next` to a
+   * buffer in a versioned, position independent and endian neutral format.
+   * Fonts and image handles are written into per frame tables and referenced
+   * by index, text is stored inline. Custom commands reference callbacks of the
+   * writing process and are skipped. Frames can be appended to each other to
+   * record a whole session.
+   *
+   * ```c
+   * capture_writer_init(&writer, &alloc);
+   * // every frame
+   * capture_write(&writer, &ctx, &file);
+   * ```
+   */
+  NK_API void capture_writer_init(struct capture_writer*, const struct allocator*);
+  /** \brief Frees the scratch tables of the writer */
+  NK_API void capture_writer_free(struct capture_writer*);
+
+  /**
+   * \brief Appends the command list of the current frame to `out`
+   *
+   * \param[in] writer | Must point to a previously initialized `capture_writer`
+   * \param[in] ctx    | Must point to an previously initialized `context` struct at the end of a frame
+   * \param[out] out   | Buffer the frame is appended to
+   *
+   * \returns `false(0)` if `out` ran out of memory, `out` then ends with the previous frame again
+   */
+  NK_API bool capture_write(struct capture_writer*, context*, memory_buffer* out);
+
+  /**
+   * \brief Validates a captured frame without copying it
+   *
+   * \details
+   * `data` can point to a memory mapped capture file. The next frame of a
+   * recording starts at `data + reader->size`.
+   *
+   * \returns `false(0)` if `data` does not start with a frame of a supported version
+   */
+  NK_API bool capture_reader_init(struct capture_reader*, const void* data, std::size_t size);
+  /** \brief Returns the height of a font in the font table of a capture */
+  NK_API float capture_font_height(const struct capture_reader*, unsigned int index);
+  /** \brief Returns the handle an image had in the capturing process */
+  NK_API resource_handle capture_image_handle(const struct capture_reader*, unsigned int index);
+
+  /**
+   * \brief Decodes a captured frame into a command list
+   *
+   * \details
+   * The commands are linked like the commands of a context, starting at the
+   * beginning of `out`, and can be tessellated with `convert_replay`.
+   *
+   * \param[in] reader   | Frame opened with `capture_reader_init`
+   * \param[in] bindings | Fonts and images to use in place of the captured handles, can be NULL
+   * \param[out] out     | Cleared and filled with the decoded commands
+   *
+   * \returns `false(0)` if the frame is malformed or `out` ran out of memory
+   */
+  NK_API bool capture_replay(const struct capture_reader*, const struct capture_bindings*, memory_buffer* out);
+
+  /**
+   * \brief Initializes an encoder that sends frames as differences to the previous frame
+   *
+   * \details
+   * Each message lists the visible windows in drawing order. Windows whose
+   * encoded commands are byte for byte equal to the previous frame are sent as
+   * a reference to it. Changed windows keep the records they share at their
+   * start and end with the previous frame and only send the records in between.
+   * Every open popup and the overlay are diffed like windows. The first message and the first
+   * one after `stream_encoder_reset` are key frames that contain everything, so
+   * reset the encoder whenever a client connects or lost a message.
+   *
+   * ```c
+   * stream_encoder_init(&enc, &alloc);
+   * // every frame
+   * buffer_clear(&msg);
+   * stream_encode(&enc, &ctx, &msg);
+   * write(fd, buffer_memory(&msg), msg.allocated);
+   * ```
+   */
+  NK_API void stream_encoder_init(struct stream_encoder*, const struct allocator*);
+  /** \brief Makes the next message a key frame */
+  NK_API void stream_encoder_reset(struct stream_encoder*);
+  /** \brief Frees all memory held by the encoder */
+  NK_API void stream_encoder_free(struct stream_encoder*);
+
+  /**
+   * \brief Appends the message for the current frame to `out`
+   *
+   * \returns `false(0)` if memory ran out, nothing is appended to `out` and the next message is a key frame
+   */
+  NK_API bool stream_encode(struct stream_encoder*, context*, memory_buffer* out);
+
+  /**
+   * \brief Returns the size of the message starting at `data` or zero if `size` does not cover its header yet
+   */
+  NK_API std::size_t stream_message_size(const void* data, std::size_t size);
+
+  /** \brief Initializes a decoder for the messages of one `stream_encoder` */
+  NK_API void stream_decoder_init(struct stream_decoder*, const struct allocator*);
+  /** \brief Frees all memory held by the decoder */
+  NK_API void stream_decoder_free(struct stream_decoder*);
+
+  /**
+   * \brief Applies one message and decodes the resulting frame into a command list like `capture_replay`
+   *
+   * \param[in] dec      | Must point to a previously initialized `stream_decoder`
+   * \param[in] data     | Message written by `stream_encode`
+   * \param[in] size     | Bytes available at `data`
+   * \param[in] bindings | Fonts and images to use in place of the sent handles, can be NULL
+   * \param[out] out     | Cleared and filled with the decoded commands
+   *
+   * \returns `false(0)` for malformed messages or a difference without its
+   * previous frame, which the frame counter of each message reveals after a lost
+   * message. The decoder then waits for the next key frame.
+   */
+  NK_API bool stream_decode(struct stream_decoder*, const void* data, std::size_t size, const struct capture_bindings*, memory_buffer* out);
+
+  /**
+   * \brief Initializes three frame slots to pass finished frames to a render thread
+   *
+   * \details
+   * `frame_publish` copies the command list of a finished frame into the slot
+   * owned by the UI thread and swaps it with the shared slot using a single
+   * atomic exchange. `frame_acquire` swaps the shared slot with the one owned by
+   * the render thread if a newer frame was published. Neither call blocks or
+   * locks, the render thread always gets the latest frame and frames it did not
+   * pick up in time are skipped. The UI thread can `clear` the context and start
+   * the next frame right after publishing.
+   *
+   * Fonts referenced by text commands and images have to stay valid while the
+   * render thread uses them and custom command callbacks run on the render thread.
+   *
+   * ```c
+   * // UI thread
+   * frame_publish(&handoff, &ctx);
+   * clear(&ctx);
+   * // render thread
+   * const struct frame_slot* slot = frame_acquire(&handoff);
+   * if (slot)
+   *     convert_replay(&list, &slot->commands, &cmds, &verts, &idx, &cfg);
+   * ```
+   */
+  NK_API void frame_handoff_init(struct frame_handoff*, const struct allocator*);
+  /** \brief Frees all slots, no thread may use the handoff anymore */
+  NK_API void frame_handoff_free(struct frame_handoff*);
+
+  /**
+   * \brief Publishes the command list of the current frame, called from the UI thread
+   *
+   * \returns `false(0)` if the slot ran out of memory, nothing is published then
+   */
+  NK_API bool frame_publish(struct frame_handoff*, context*);
+
+  /**
+   * \brief Returns the latest published frame, called from the render thread
+   *
+   * \details
+   * The slot stays valid and unchanged until the next `frame_acquire` call.
+   *
+   * \returns the slot or NULL if no frame was published yet
+   */
+  NK_API const struct frame_slot* frame_acquire(struct frame_handoff*);
+
 #ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
 
   /**
@@ -217,6 +452,300 @@ namespace nk {
    */
   NK_API flag convert(struct context*, struct buffer* cmds, struct buffer* vertices, struct buffer* elements, const struct convert_config*);
 
+  /**
+   * \brief Converts like `convert` but writes every vertex through `writer`
+   *
+   * \details
+   * `convert` already picks a specialized writer for layouts made of a float
+   * position, a float texture coordinate and an 8-bit or float RGBA color. This
+   * entry point is for writers built at compile time, see the templated `convert`.
+   * Passing a null writer behaves exactly like `convert`.
+   *
+   * \param[in] writer Writes one vertex of `convert_config::vertex_size` bytes and returns the next address
+   */
+  NK_API flag convert_with_writer(struct context*, memory_buffer* cmds, memory_buffer* vertices, memory_buffer* elements, const struct convert_config*, draw_vertex_writer writer);
+
+  /**
+   * \brief Converts like `convert` but packs vertices through `writer`
+   *
+   * \details
+   * Tessellation stages up to `NK_DRAW_VERTEX_BLOCK` vertices and hands them to
+   * `writer` at once, so a writer instantiated for a fixed layout runs its loop
+   * without a call per vertex. Passing a null writer behaves exactly like `convert`.
+   *
+   * \param[in] writer Writes `count` vertices of `convert_config::vertex_size` bytes and returns the next address
+   */
+  NK_API flag convert_with_block_writer(struct context*, memory_buffer* cmds, memory_buffer* vertices, memory_buffer* elements, const struct convert_config*, draw_vertex_block_writer writer);
+
+  /**
+   * \brief Converts with the vertex layout fixed at compile time
+   *
+   * \details
+   * ```c
+   * flag convert<draw_vertex_layout_pos2f_uv2f_rgba8>(ctx, &cmds, &verts, &idx, &cfg);
+   * ```
+   * `Layout` is a `draw_vertex_layout_desc` and must describe the same vertex as
+   * `convert_config::vertex_layout`, which is still used to validate the config.
+   */
+  template <class Layout>
+  flag
+  convert(struct context* ctx, memory_buffer* cmds, memory_buffer* vertices,
+          memory_buffer* elements, const struct convert_config* config) {
+    NK_ASSERT(!config || config->vertex_size == Layout::size);
+    return convert_with_block_writer(ctx, cmds, vertices, elements, config, draw_vertex_write_block<Layout>);
+  }
+
+  /**
+   * \brief Converts like `convert` but emits one `draw_instance` per simple primitive
+   *
+   * \details
+   * Filled and stroked rectangles, rounded rectangles, circles, axis aligned
+   * lines, images and glyph quads are written as a single `draw_instance` into
+   * `instances` instead of being tessellated. A backend expands each instance
+   * into a quad in its vertex shader, evaluates the rounded rectangle distance
+   * for `rounding` and `thickness` itself and multiplies `color` with the texture
+   * sampled at `uv`, so anti-aliasing is done by the shader. Everything else is
+   * tessellated into `vertices` and `elements` like `convert` does.
+   *
+   * Draw commands with a non zero `draw_command::instance_count` draw that many
+   * instances and have no elements. Instances are stored in draw command order,
+   * just like elements. `convert_config::cache` is ignored.
+   *
+   * ```c
+   * draw_foreach(cmd, &ctx, &cmds) {
+   *     if (cmd->instance_count)
+   *         // draw `cmd->instance_count` instances starting at the running instance offset
+   *     else if (cmd->elem_count)
+   *         // draw triangles as with `convert`
+   * }
+   * ```
+   *
+   * \param[in] instances Buffer receiving the `draw_instance` records
+   *
+   * \returns the results of `convert` or `NK_CONVERT_INSTANCE_BUFFER_FULL`
+   */
+  NK_API flag convert_instanced(struct context*, memory_buffer* cmds, memory_buffer* vertices, memory_buffer* elements, memory_buffer* instances, const struct convert_config*);
+
+  /**
+   * \brief Initializes a vertex cache which can be set as `convert_config::cache`
+   *
+   * \details
+   * With a cache `convert` keeps the vertices, indices and draw commands of every
+   * window and only tessellates windows whose draw commands changed since the
+   * previous call. All other windows are copied into the output buffers with
+   * rebased indices. Popups and the cursor overlay are always converted.
+   * Each window starts with its own vertex draw command while caching.
+   *
+   * Font glyph data is not part of the cached key, so call `draw_cache_clear`
+   * after baking or switching font atlas textures.
+   *
+   * ```c
+   * void draw_cache_init(struct draw_cache*, const struct allocator*);
+   * ```
+   *
+   * \param[in] cache   | Must point to a `draw_cache` struct to initialize
+   * \param[in] alloc   | Allocator used for the cached window output
+   */
+  NK_API void draw_cache_init(struct draw_cache*, const struct allocator*);
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+  NK_API void draw_cache_init_default(struct draw_cache*);
+#endif
+  /** \brief Drops all cached window output so the next `convert` tessellates every window */
+  NK_API void draw_cache_clear(struct draw_cache*);
+  /** \brief Frees all memory held by the cache */
+  NK_API void draw_cache_free(struct draw_cache*);
+
+  /**
+   * \brief Initializes a batching pass which can be set as `convert_config::batch`
+   *
+   * \details
+   * After a successful `convert`, `convert_parallel` or `convert_replay` the pass
+   * drops draw commands without elements and merges commands with equal clip
+   * rectangle, texture, userdata and base vertex. A command is also moved in front
+   * of up to `NK_DRAW_BATCH_LOOKBACK` earlier commands into a compatible one if
+   * its vertex bounds do not touch any of the commands it passes, so the visual
+   * result does not change. Indices are reordered in the element buffer, vertices
+   * stay where they are.
+   *
+   * The pass is not run by `convert_stream` since chunks are flushed early.
+   *
+   * ```c
+   * void draw_batch_init(struct draw_batch*, const struct allocator*);
+   * ```
+   *
+   * \param[in] batch   | Must point to a `draw_batch` struct to initialize
+   * \param[in] alloc   | Allocator used for scratch memory of the pass
+   */
+  NK_API void draw_batch_init(struct draw_batch*, const struct allocator*);
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+  NK_API void draw_batch_init_default(struct draw_batch*);
+#endif
+  /** \brief Frees the scratch memory of the batching pass */
+  NK_API void draw_batch_free(struct draw_batch*);
+
+  /**
+   * \brief Runs the batching pass on already converted output of `list`
+   *
+   * \details
+   * `draw_batch::commands_before` and `draw_batch::commands_after` hold the
+   * draw call count before and after the pass. If no scratch memory could be
+   * allocated the output is left untouched.
+   *
+   * ```c
+   * void draw_list_batch(struct draw_batch*, struct draw_list*);
+   * ```
+   *
+   * \param[in] batch   | Batching pass initialized with `draw_batch_init`
+   * \param[in] list    | Draw list with converted commands, vertices and elements
+   */
+  NK_API void draw_list_batch(struct draw_batch*, struct draw_list*);
+
+  /**
+   * \brief Initializes scratch state for `convert_parallel`
+   *
+   * \details
+   * ```c
+   * void convert_workers_init(struct convert_workers*, const struct allocator*, int count, plugin_dispatch dispatch, resource_handle userdata);
+   * ```
+   *
+   * \param[in] workers  | Must point to a `convert_workers` struct to initialize
+   * \param[in] alloc    | Allocator used for the per worker scratch buffers
+   * \param[in] count    | Number of workers, clamped to `NK_CONVERT_MAX_WORKERS`
+   * \param[in] dispatch | Optional callback to run worker tasks on an existing thread pool or NULL to start
+   *                      `count - 1` threads that are kept until `convert_workers_free`
+   * \param[in] userdata | Passed to `dispatch`
+   */
+  NK_API void convert_workers_init(struct convert_workers*, const struct allocator*, int count, plugin_dispatch dispatch, resource_handle userdata);
+  /** \brief Stops the worker threads and frees all scratch memory of the workers */
+  NK_API void convert_workers_free(struct convert_workers*);
+
+  /**
+   * \brief Initializes a planner to measure the buffer sizes `convert` needs
+   *
+   * \details
+   * `convert_measure` converts the current frame into the planner scratch buffers
+   * instead of the output buffers and records the bytes each buffer needed at its
+   * peak, including temporary tessellation memory and alignment. Every measured
+   * frame is added to a worst case envelope. Buffers for `buffer_init_fixed` with
+   * at least these sizes, aligned to `alignof(std::max_align_t)`, never report
+   * `NK_CONVERT_*_BUFFER_FULL` for the measured frames.
+   *
+   * ```c
+   * convert_planner_init(&planner, &alloc);
+   * // every frame before or instead of convert
+   * convert_measure(&ctx, &planner, &cfg, 0);
+   * // planner.envelope holds the sizes for fixed buffers
+   * ```
+   */
+  NK_API void convert_planner_init(struct convert_planner*, const struct allocator*);
+  /** \brief Starts a new worst case envelope */
+  NK_API void convert_planner_reset(struct convert_planner*);
+  /** \brief Frees the scratch buffers of the planner */
+  NK_API void convert_planner_free(struct convert_planner*);
+
+  /**
+   * \brief Measures the bytes `convert` needs for the current frame without touching its output buffers
+   *
+   * \param[in] ctx      Must point to an previously initialized `context` struct at the end of a frame
+   * \param[in] planner  Must point to a previously initialized `convert_planner`
+   * \param[in] config   Configuration the frame will be converted with, `convert_config::cache` is ignored
+   * \param[out] frame   Optional, receives the requirements of this frame
+   *
+   * \returns one of enum convert_result error codes, only allocation failures of the scratch buffers can fail
+   */
+  NK_API flag convert_measure(struct context*, struct convert_planner*, const struct convert_config*, struct convert_requirements* frame);
+
+  /**
+   * \brief Converts a command list decoded by `capture_replay` like `convert` converts a context
+   *
+   * \details
+   * Iterate the output with `draw_list_foreach(cmd, list, cmds)`.
+   *
+   * \param[out] list   Draw list to set up for the output
+   * \param[in] replay  Buffer filled by `capture_replay`
+   */
+  NK_API flag convert_replay(struct draw_list* list, const memory_buffer* replay, memory_buffer* cmds, memory_buffer* vertices, memory_buffer* elements, const struct convert_config*);
+
+  /**
+   * \brief Starts converting the current frame in chunks that each fit the output buffers
+   *
+   * \details
+   * Instead of dropping geometry once a fixed buffer is full, `convert_stream_next`
+   * stops before the first command that does not fit anymore, undoes its partial
+   * output and stores where to continue in `stream`. Every chunk is a complete
+   * draw list with indices starting at zero, so it can be uploaded and drawn on
+   * its own while the next chunk is tessellated. The draw state at the end of a
+   * chunk is carried into the first draw command of the next one.
+   * Chunks are split between commands, `convert_config::cache` is ignored.
+   *
+   * ```c
+   * convert_stream_begin(&stream);
+   * while (!stream.done) {
+   *     buffer_init_fixed(&cmds, ...); // next free ring slot
+   *     if (convert_stream_next(&ctx, &stream, &cmds, &verts, &idx, &cfg))
+   *         break; // a single command is larger than a chunk
+   *     draw_foreach(cmd, &ctx, &cmds) { ... }
+   * }
+   * ```
+   */
+  NK_API void convert_stream_begin(struct convert_stream*);
+
+  /**
+   * \brief Converts the next chunk of the frame started with `convert_stream_begin`
+   *
+   * \param[in] ctx      Must point to an previously initialized `context` struct at the end of a frame
+   * \param[in] stream   Resume token, `convert_stream::done` is set after the last chunk
+   * \param[out] cmds     Cleared buffer to hold the vertex draw commands of the chunk
+   * \param[out] vertices Cleared buffer to hold the vertices of the chunk
+   * \param[out] elements Cleared buffer to hold the vertex indices of the chunk
+   * \param[in] config   Must point to a filled out `config` struct to configure the conversion process
+   *
+   * \returns `NK_CONVERT_SUCCESS` for every produced chunk or the
+   * `NK_CONVERT_*_BUFFER_FULL` flags if a single command does not fit into empty
+   * buffers. The stream is left unchanged in that case and can be continued with
+   * larger buffers.
+   */
+  NK_API flag convert_stream_next(struct context*, struct convert_stream*, memory_buffer* cmds, memory_buffer* vertices, memory_buffer* elements, const struct convert_config*);
+
+  /**
+   * \brief Converts the whole frame chunk by chunk and passes every chunk to `flush`
+   *
+   * \details
+   * The buffers are cleared before each chunk and can be reused as soon as
+   * `flush` returns, e.g. small persistently mapped upload buffers.
+   *
+   * \param[in] flush    Called once per chunk with the draw list to iterate with `draw_list_foreach`
+   * \param[in] userdata Passed to `flush`
+   *
+   * \returns one of enum convert_result error codes, see `convert_stream_next`
+   */
+  NK_API flag convert_stream(struct context*, memory_buffer* cmds, memory_buffer* vertices, memory_buffer* elements, const struct convert_config*, convert_flush_f flush, resource_handle userdata);
+
+  /**
+   * \brief Same as `convert` but tessellates windows on multiple workers
+   *
+   * \details
+   * The command list is split into one segment per window, one per open popup
+   * and one for the overlay. Each worker converts a contiguous run of segments
+   * into its own buffers which are afterwards joined into the output buffers
+   * with rebased indices. A worker predicts the draw state left by the segment
+   * before its first one. If the prediction turns out wrong its segments are
+   * converted again on the calling thread, so the output always matches `convert`.
+   * Font glyph queries and the callbacks of `command_custom` are called from
+   * worker threads, concurrently with each other, and must be thread safe.
+   * Falls back to `convert` if `convert_config::cache` is set.
+   *
+   * \param[in] ctx      Must point to an previously initialized `context` struct at the end of a frame
+   * \param[in] workers  Must point to previously initialized `convert_workers`
+   * \param[out] cmds     Must point to a previously initialized buffer to hold converted vertex draw commands
+   * \param[out] vertices Must point to a previously initialized buffer to hold all produced vertices
+   * \param[out] elements Must point to a previously initialized buffer to hold all produced vertex indices
+   * \param[in] config   Must point to a filled out `config` struct to configure the conversion process
+   *
+   * \returns one of enum convert_result error codes
+   */
+  NK_API flag convert_parallel(struct context*, struct convert_workers*, memory_buffer* cmds, memory_buffer* vertices, memory_buffer* elements, const struct convert_config*);
+
   /**
    * \brief Returns a draw vertex command buffer iterator to iterate over the vertex draw command buffer
    *
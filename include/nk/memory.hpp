@@ -39,10 +39,43 @@ namespace nk {
    * NK_INCLUDE_DEFAULT_ALLOCATOR which uses the standard library memory
    * allocation functions malloc and free and takes over complete control over
    * memory in this library.
+   *
+   * With NK_INCLUDE_VIRTUAL_MEMORY a buffer can also reserve a large address
+   * range up front and commit pages only once they are used. Such a buffer
+   * never copies on growth and its memory never moves, the reserved size is
+   * its upper bound. Optionally transparent huge pages are requested.
    */
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
   NK_API void buffer_init_default(memory_buffer*);
 #endif
+#ifdef NK_INCLUDE_VIRTUAL_MEMORY
+  NK_API void buffer_init_virtual(memory_buffer*, std::size_t reserve, bool huge_pages);
+#endif
+
+  /**
+   * \page Allocation Guard
+   * Verifies that steady state frames never call the allocator. Initialize a
+   * guard over your allocator and pass the allocator returned by
+   * `allocation_guard_allocator` to `init`, `init_custom`, `buffer_init`,
+   * `str_init` or `font_atlas_init`. Run a few warmup frames, then call
+   * `allocation_guard_arm`. From then on every allocation and free made
+   * through any of these is counted. Each call is passed with its call site
+   * to the report callback, or trips an assertion if there is none.
+   *
+   * ```c
+   * struct allocation_guard guard;
+   * allocation_guard_init(&guard, &alloc, 0, handle_id(0));
+   * struct allocator guarded = allocation_guard_allocator(&guard);
+   * init(&ctx, &guarded, &font);
+   * // ... warmup frames
+   * allocation_guard_arm(&guard);
+   * // ... frames, guard.allocs and guard.frees stay zero
+   * ```
+   */
+  NK_API void allocation_guard_init(struct allocation_guard*, const struct allocator* parent, allocation_report_f report, resource_handle userdata);
+  NK_API struct allocator allocation_guard_allocator(struct allocation_guard*);
+  NK_API void allocation_guard_arm(struct allocation_guard*);
+  NK_API void allocation_guard_disarm(struct allocation_guard*);
   NK_API void buffer_init(memory_buffer*, const allocator*, std::size_t initial_size);
   NK_API void buffer_init_fixed(memory_buffer*, void* memory, std::size_t size);
   NK_API void buffer_info(memory_status*, const memory_buffer*);
@@ -54,6 +87,7 @@ namespace nk {
   NK_API void* buffer_memory(const memory_buffer*);
   NK_API const void* buffer_memory_const(const memory_buffer*);
   NK_API std::size_t buffer_total(const memory_buffer*);
+  NK_LIB void buffer_usage(memory_usage*, const memory_buffer*);
 
 #ifndef NK_MEMCPY
   NK_LIB void* memcopy(void* dst, const void* src, std::size_t n);
@@ -63,10 +97,12 @@ namespace nk {
 #endif
 
   /* pool */
-  NK_LIB void pool_init(pool* pool, const allocator* alloc, unsigned int capacity);
+  NK_LIB void pool_init(pool* pool, const allocator* alloc);
   NK_LIB void pool_free(pool* pool);
   NK_LIB void pool_init_fixed(pool* pool, void* memory, std::size_t size);
-  NK_LIB page_element* pool_alloc(pool* pool);
+  NK_LIB void* pool_alloc(pool* pool, page_type type);
+  NK_LIB void pool_trim(pool* pool);
+  NK_LIB void pool_usage(struct pool_usage* usage, const pool* pool, page_type type);
 
 
 }
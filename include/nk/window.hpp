@@ -114,6 +114,8 @@ namespace nk {
    * \ref window_is_closed                 | Returns if the currently processed window was closed
    * \ref window_is_hidden                 | Returns if the currently processed window was hidden
    * \ref window_is_active                 | Same as window_has_focus for some reason
+   * \ref window_changed                   | Returns if the draw commands of the window with given name changed since the last frame
+   * \ref window_memory_info               | Returns the state table memory of the window with given name
    * \ref window_is_hovered                | Returns if the currently processed window is currently being hovered by mouse
    * \ref window_is_any_hovered            | Return if any window currently hovered
    * \ref item_is_any_active               | Returns if any window or widgets is currently hovered or active
@@ -576,6 +578,39 @@ namespace nk {
    */
   NK_API bool window_is_active(const context* ctx, const char* name);
 
+  /**
+   * # # window_changed
+   * Returns if the draw commands of a window differ from the ones of the previous frame
+   * ```c
+   * bool window_changed(struct context *ctx, const char *name);
+   * ```
+   *
+   * Parameter   | Description
+   * ------------|-----------------------------------------------------------
+   * \param[in] ctx     | Must point to an previously initialized `context` struct at the end of a frame
+   * \param[in] name    | Identifier of window you want to check for changes
+   *
+   * \returns `true(1)` if the window draw commands changed or `false(0)` if unchanged or window not found
+   */
+  NK_API bool window_changed(context* ctx, const char* name);
+
+  /**
+   * # # window_memory_info
+   * Fills out the number of state tables and values and their memory of a window
+   * ```c
+   * bool window_memory_info(const struct context *ctx, const char *name, struct window_memory_stats *stats);
+   * ```
+   *
+   * Parameter   | Description
+   * ------------|-----------------------------------------------------------
+   * \param[in] ctx     | Must point to an previously initialized `context` struct
+   * \param[in] name    | Identifier of window you want to query
+   * \param[out] stats  | Must point to a `window_memory_stats` struct to fill out
+   *
+   * \returns `true(1)` if the window was found or `false(0)` otherwise
+   */
+  NK_API bool window_memory_info(const context* ctx, const char* name, struct window_memory_stats* stats);
+
   /**
    * # # window_is_any_hovered
    * \returns if the any window is being hovered
@@ -797,6 +832,7 @@ namespace nk {
 #ifndef NK_DTOA
   NK_LIB char* dtoa(char* s, double n);
 #endif
+  NK_LIB float text_glyph_width(const user_font* font, const char* glyph, int glyph_len, rune unicode);
   NK_LIB int text_clamp(const user_font* font, const char* text, int text_len, float space, int* glyphs, float* text_width, rune* sep_list, int sep_count);
   NK_LIB vec2f text_calculate_text_bounds(const user_font* font, const char* begin, int byte_len, float row_height, const char** remaining, vec2f* out_offset, int* glyphs, int op);
 #ifdef NK_INCLUDE_STANDARD_VARARGS
@@ -819,6 +855,8 @@ namespace nk {
   NK_LIB void command_buffer_init(command_buffer* cb, memory_buffer* b, command_clipping clip);
   NK_LIB void command_buffer_reset(command_buffer* b);
   NK_LIB void* command_buffer_push(command_buffer* b, command_type t, std::size_t size);
+  NK_LIB bool command_bounds(const command* cmd, rectf* bounds);
+  NK_LIB std::size_t command_size(const command* cmd);
   NK_LIB void draw_symbol(command_buffer* out, symbol_type type, rectf content, color background, color foreground, float border_width, const user_font* font);
 
   /* buffering */
@@ -844,9 +882,10 @@ namespace nk {
   NK_LIB void insert_window(context* ctx, window* win, window_insert_location loc);
 
   /* page-element */
-  NK_LIB page_element* create_page_element(context* ctx);
-  NK_LIB void lipage_element_into_freelist(context* ctx, page_element* elem);
-  NK_LIB void free_page_element(context* ctx, page_element* elem);
+  NK_LIB std::size_t page_element_size(page_type type);
+  NK_LIB std::size_t page_element_align(page_type type);
+  NK_LIB void* create_page_element(context* ctx, page_type type);
+  NK_LIB void free_page_element(context* ctx, page_type type, void* elem);
 
   /* table */
   NK_LIB table* create_table(context* ctx);
@@ -855,6 +894,8 @@ namespace nk {
   NK_LIB void push_table(window* win, table* tbl);
   NK_LIB std::uint32_t* add_value(context* ctx, window* win, hash name, std::uint32_t value);
   NK_LIB std::uint32_t* find_value(const window* win, hash name);
+  NK_LIB void sweep_tables(context* ctx, window* win);
+  NK_LIB void free_value_index(context* ctx, window* win);
 
   /* panel */
   NK_LIB void* create_panel(context* ctx);
@@ -1,4 +1,14 @@
 #include <cstring>
+#ifdef NK_INCLUDE_VIRTUAL_MEMORY
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#endif
 #include <nk/nuklear.hpp>
 
 namespace nk {
@@ -29,6 +39,69 @@ namespace nk {
   }
 #endif
 
+  NK_API void
+  allocation_guard_init(struct allocation_guard* guard, const struct allocator* parent,
+                        const allocation_report_f report, const resource_handle userdata) {
+    NK_ASSERT(guard);
+    NK_ASSERT(parent);
+    if (!guard || !parent)
+      return;
+    zero_struct(*guard);
+    guard->parent = *parent;
+    guard->report = report;
+    guard->userdata = userdata;
+  }
+  INTERN void*
+  allocation_guard_alloc(resource_handle handle, void* old, const std::size_t size) {
+    struct allocation_guard* guard = (struct allocation_guard*) handle.ptr;
+    void* memory = guard->parent.alloc(guard->parent.userdata, old, size);
+    if (guard->armed) {
+      guard->allocs++;
+      if (guard->report)
+        guard->report(guard->userdata, NK_RETURN_ADDRESS(), memory, size);
+      else
+        NK_ASSERT(0 && "allocation after warmup");
+    }
+    return memory;
+  }
+  INTERN void
+  allocation_guard_free(resource_handle handle, void* memory) {
+    struct allocation_guard* guard = (struct allocation_guard*) handle.ptr;
+    if (guard->armed) {
+      guard->frees++;
+      if (guard->report)
+        guard->report(guard->userdata, NK_RETURN_ADDRESS(), memory, 0);
+      else
+        NK_ASSERT(0 && "free after warmup");
+    }
+    guard->parent.free(guard->parent.userdata, memory);
+  }
+  NK_API struct allocator
+  allocation_guard_allocator(struct allocation_guard* guard) {
+    struct allocator alloc;
+    NK_ASSERT(guard);
+    alloc.userdata.ptr = guard;
+    alloc.alloc = allocation_guard_alloc;
+    alloc.free = allocation_guard_free;
+    return alloc;
+  }
+  NK_API void
+  allocation_guard_arm(struct allocation_guard* guard) {
+    NK_ASSERT(guard);
+    if (!guard)
+      return;
+    guard->armed = true;
+    guard->allocs = 0;
+    guard->frees = 0;
+  }
+  NK_API void
+  allocation_guard_disarm(struct allocation_guard* guard) {
+    NK_ASSERT(guard);
+    if (!guard)
+      return;
+    guard->armed = false;
+  }
+
   NK_API void
   buffer_init(memory_buffer* b, const allocator* a,
               const std::size_t initial_size) {
@@ -60,6 +133,116 @@ namespace nk {
     b->memory.size = size;
     b->size = size;
   }
+#ifdef NK_INCLUDE_VIRTUAL_MEMORY
+  INTERN std::size_t
+  virtual_page_size(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (std::size_t) info.dwPageSize;
+#else
+    return (std::size_t) sysconf(_SC_PAGESIZE);
+#endif
+  }
+  INTERN void*
+  virtual_reserve(const std::size_t size, const std::size_t align) {
+#ifdef _WIN32
+    NK_UNUSED(align);
+    return VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    /* reserve more than needed so the range can start at an `align` boundary */
+    const std::size_t total = size + align;
+    void* raw = mmap(0, total, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (raw == MAP_FAILED)
+      return 0;
+    std::uint8_t* memory = (std::uint8_t*) NK_ALIGN_PTR(raw, align);
+    const std::size_t head = (std::size_t) (memory - (std::uint8_t*) raw);
+    const std::size_t tail = total - head - size;
+    if (head)
+      munmap(raw, head);
+    if (tail)
+      munmap(memory + size, tail);
+    return memory;
+#endif
+  }
+  INTERN bool
+  virtual_commit(void* memory, const std::size_t size) {
+#ifdef _WIN32
+    return VirtualAlloc(memory, size, MEM_COMMIT, PAGE_READWRITE) != 0;
+#else
+    return mprotect(memory, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+  }
+  INTERN void
+  virtual_release(void* memory, const std::size_t size) {
+#ifdef _WIN32
+    NK_UNUSED(size);
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munmap(memory, size);
+#endif
+  }
+  NK_API void
+  buffer_init_virtual(memory_buffer* b, const std::size_t reserve, const bool huge_pages) {
+    NK_ASSERT(b);
+    NK_ASSERT(reserve);
+    if (!b || !reserve)
+      return;
+
+    /* stays an empty fixed buffer if the address range can not be reserved */
+    zero(b, sizeof(*b));
+    b->type = allocation_type::BUFFER_FIXED;
+
+    std::size_t commit_size = virtual_page_size();
+#ifdef MADV_HUGEPAGE
+    if (huge_pages)
+      commit_size = std::max(commit_size, (std::size_t) NK_BUFFER_HUGE_PAGE_SIZE);
+#else
+    NK_UNUSED(huge_pages);
+#endif
+    const std::size_t size = (reserve + commit_size - 1) / commit_size * commit_size;
+    void* memory = virtual_reserve(size, commit_size);
+    NK_ASSERT(memory);
+    if (!memory)
+      return;
+#ifdef MADV_HUGEPAGE
+    if (huge_pages)
+      madvise(memory, size, MADV_HUGEPAGE);
+#endif
+
+    b->type = allocation_type::BUFFER_VIRTUAL;
+    b->memory.ptr = memory;
+    b->memory.size = size;
+    b->size = size;
+    b->grow_factor = 2.0f;
+    b->commit_size = commit_size;
+  }
+  INTERN bool
+  buffer_commit(memory_buffer* b, const buffer_allocation_type type, const std::size_t size) {
+    /* front and back grow towards each other from both ends of the reserved range */
+    const unsigned side = static_cast<unsigned>(type);
+    const unsigned other = static_cast<unsigned>(type == buffer_allocation_type::BUFFER_FRONT ? buffer_allocation_type::BUFFER_BACK : buffer_allocation_type::BUFFER_FRONT);
+    const std::size_t used = (type == buffer_allocation_type::BUFFER_FRONT) ? b->allocated + size : b->memory.size - b->size + size;
+    if (used <= b->committed[side])
+      return true;
+
+    std::size_t target = std::max(used, (std::size_t) ((float) b->committed[side] * b->grow_factor));
+    target = (target + b->commit_size - 1) / b->commit_size * b->commit_size;
+    target = std::min(target, b->memory.size - b->committed[other]);
+    if (target > b->committed[side]) {
+      std::uint8_t* memory = (std::uint8_t*) b->memory.ptr;
+      if (type == buffer_allocation_type::BUFFER_FRONT)
+        memory += b->committed[side];
+      else
+        memory += b->memory.size - target;
+      if (!virtual_commit(memory, target - b->committed[side]))
+        return false;
+      b->committed[side] = target;
+      b->grows++;
+    }
+    return true;
+  }
+#endif
   NK_LIB void*
   buffer_align(void* unaligned,
                const std::size_t align, std::size_t* alignment,
@@ -164,6 +347,7 @@ namespace nk {
       b->memory.ptr = buffer_realloc(b, capacity, &b->memory.size);
       if (!b->memory.ptr)
         return 0;
+      b->grows++;
 
       /* align newly allocated pointer */
       if (type == buffer_allocation_type::BUFFER_FRONT)
@@ -172,12 +356,18 @@ namespace nk {
         unaligned = ptr_add(void, b->memory.ptr, b->size - size);
       memory = buffer_align(unaligned, align, &alignment, type);
     }
+#ifdef NK_INCLUDE_VIRTUAL_MEMORY
+    /* virtual buffers never move, only more of the reserved range is committed */
+    if (b->type == allocation_type::BUFFER_VIRTUAL && !buffer_commit(b, type, size + alignment))
+      return 0;
+#endif
     if (type == buffer_allocation_type::BUFFER_FRONT)
       b->allocated += size + alignment;
     else
       b->size -= (size + alignment);
     b->needed += alignment;
     b->calls++;
+    b->peak = std::max(b->peak, b->allocated + (b->memory.size - b->size));
     return memory;
   }
   NK_API void
@@ -239,6 +429,12 @@ namespace nk {
       return;
     if (b->type == allocation_type::BUFFER_FIXED)
       return;
+#ifdef NK_INCLUDE_VIRTUAL_MEMORY
+    if (b->type == allocation_type::BUFFER_VIRTUAL) {
+      virtual_release(b->memory.ptr, b->memory.size);
+      return;
+    }
+#endif
     if (!b->pool.free)
       return;
     NK_ASSERT(b->pool.free);
@@ -256,6 +452,20 @@ namespace nk {
     s->memory = b->memory.ptr;
     s->calls = b->calls;
   }
+  NK_LIB void
+  buffer_usage(memory_usage* usage, const memory_buffer* b) {
+    NK_ASSERT(usage);
+    NK_ASSERT(b);
+    if (!usage || !b)
+      return;
+    usage->used = b->allocated + (b->memory.size - b->size);
+    usage->peak = std::max(b->peak, usage->used);
+    usage->capacity = b->memory.size;
+    if (b->type == allocation_type::BUFFER_VIRTUAL)
+      usage->capacity = b->committed[0] + b->committed[1];
+    usage->calls = b->calls;
+    usage->grows = b->grows;
+  }
   NK_API void*
   buffer_memory(const memory_buffer* buffer) {
     NK_ASSERT(buffer);
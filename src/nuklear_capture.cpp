@@ -0,0 +1,1021 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <nk/nuklear.hpp>
+
+namespace nk {
+  /* ===============================================================
+   *
+   *                              CAPTURE
+   *
+   * ===============================================================*/
+  /*  file layout, all values little endian:
+   *
+   *  header      u32 magic, u16 version, u16 flags, u32 command count,
+   *              u32 font count, u32 image count, u32 records offset,
+   *              u32 font table offset, u32 image table offset, u32 frame size
+   *  records     u8 type, u32 payload size, payload
+   *  font table  f32 height per font
+   *  image table 8 handle bytes per image
+   *
+   *  A payload starts with the userdata handle if flag bit 0 is set,
+   *  followed by the fields of the command in declaration order. Fonts and
+   *  image handles are stored as indices into the tables. */
+  NK_GLOBAL constexpr std::uint32_t capture_magic = 0x53434B4E; /* "NKCS" */
+  NK_GLOBAL constexpr std::size_t capture_header_size = 36;
+  NK_GLOBAL constexpr std::size_t capture_record_header_size = 5;
+  NK_GLOBAL constexpr unsigned int capture_flag_userdata = 1;
+
+  enum class capture_field_type : std::uint8_t {
+    FIELD_16,
+    FIELD_32,
+    FIELD_BYTES /**!< four bytes stored as they are, used for colors */
+  };
+  struct capture_field {
+    std::uint16_t offset;
+    capture_field_type type;
+  };
+
+#define NK_CAPTURE_16(t, m) {(std::uint16_t) offsetof(t, m), capture_field_type::FIELD_16}
+#define NK_CAPTURE_32(t, m) {(std::uint16_t) offsetof(t, m), capture_field_type::FIELD_32}
+#define NK_CAPTURE_COLOR(t, m) {(std::uint16_t) offsetof(t, m), capture_field_type::FIELD_BYTES}
+#define NK_CAPTURE_VEC2(t, m) NK_CAPTURE_16(t, m.x), NK_CAPTURE_16(t, m.y)
+#define NK_CAPTURE_RECT(t) NK_CAPTURE_16(t, x), NK_CAPTURE_16(t, y), NK_CAPTURE_16(t, w), NK_CAPTURE_16(t, h)
+
+  NK_GLOBAL const capture_field capture_scissor[] = {NK_CAPTURE_RECT(command_scissor)};
+  NK_GLOBAL const capture_field capture_line[] = {
+      NK_CAPTURE_16(command_line, line_thickness), NK_CAPTURE_VEC2(command_line, begin),
+      NK_CAPTURE_VEC2(command_line, end), NK_CAPTURE_COLOR(command_line, color)};
+  NK_GLOBAL const capture_field capture_curve[] = {
+      NK_CAPTURE_16(command_curve, line_thickness), NK_CAPTURE_VEC2(command_curve, begin),
+      NK_CAPTURE_VEC2(command_curve, end), NK_CAPTURE_VEC2(command_curve, ctrl[0]),
+      NK_CAPTURE_VEC2(command_curve, ctrl[1]), NK_CAPTURE_COLOR(command_curve, color)};
+  NK_GLOBAL const capture_field capture_rect[] = {
+      NK_CAPTURE_16(command_rect, rounding), NK_CAPTURE_16(command_rect, line_thickness),
+      NK_CAPTURE_RECT(command_rect), NK_CAPTURE_COLOR(command_rect, color)};
+  NK_GLOBAL const capture_field capture_rect_filled[] = {
+      NK_CAPTURE_16(command_rect_filled, rounding), NK_CAPTURE_RECT(command_rect_filled),
+      NK_CAPTURE_COLOR(command_rect_filled, color)};
+  NK_GLOBAL const capture_field capture_rect_multi_color[] = {
+      NK_CAPTURE_RECT(command_rect_multi_color), NK_CAPTURE_COLOR(command_rect_multi_color, left),
+      NK_CAPTURE_COLOR(command_rect_multi_color, top), NK_CAPTURE_COLOR(command_rect_multi_color, bottom),
+      NK_CAPTURE_COLOR(command_rect_multi_color, right)};
+  NK_GLOBAL const capture_field capture_circle[] = {
+      NK_CAPTURE_16(command_circle, line_thickness), NK_CAPTURE_RECT(command_circle),
+      NK_CAPTURE_COLOR(command_circle, color)};
+  NK_GLOBAL const capture_field capture_circle_filled[] = {
+      NK_CAPTURE_RECT(command_circle_filled), NK_CAPTURE_COLOR(command_circle_filled, color)};
+  NK_GLOBAL const capture_field capture_arc[] = {
+      NK_CAPTURE_16(command_arc, cx), NK_CAPTURE_16(command_arc, cy), NK_CAPTURE_16(command_arc, r),
+      NK_CAPTURE_16(command_arc, line_thickness), NK_CAPTURE_32(command_arc, a[0]),
+      NK_CAPTURE_32(command_arc, a[1]), NK_CAPTURE_COLOR(command_arc, color)};
+  NK_GLOBAL const capture_field capture_arc_filled[] = {
+      NK_CAPTURE_16(command_arc_filled, cx), NK_CAPTURE_16(command_arc_filled, cy),
+      NK_CAPTURE_16(command_arc_filled, r), NK_CAPTURE_32(command_arc_filled, a[0]),
+      NK_CAPTURE_32(command_arc_filled, a[1]), NK_CAPTURE_COLOR(command_arc_filled, color)};
+  NK_GLOBAL const capture_field capture_triangle[] = {
+      NK_CAPTURE_16(command_triangle, line_thickness), NK_CAPTURE_VEC2(command_triangle, a),
+      NK_CAPTURE_VEC2(command_triangle, b), NK_CAPTURE_VEC2(command_triangle, c),
+      NK_CAPTURE_COLOR(command_triangle, color)};
+  NK_GLOBAL const capture_field capture_triangle_filled[] = {
+      NK_CAPTURE_VEC2(command_triangle_filled, a), NK_CAPTURE_VEC2(command_triangle_filled, b),
+      NK_CAPTURE_VEC2(command_triangle_filled, c), NK_CAPTURE_COLOR(command_triangle_filled, color)};
+  NK_GLOBAL const capture_field capture_polygon[] = {
+      NK_CAPTURE_COLOR(command_polygon, color), NK_CAPTURE_16(command_polygon, line_thickness),
+      NK_CAPTURE_16(command_polygon, point_count)};
+  NK_GLOBAL const capture_field capture_polygon_filled[] = {
+      NK_CAPTURE_COLOR(command_polygon_filled, color), NK_CAPTURE_16(command_polygon_filled, point_count)};
+  NK_GLOBAL const capture_field capture_polyline[] = {
+      NK_CAPTURE_COLOR(command_polyline, color), NK_CAPTURE_16(command_polyline, line_thickness),
+      NK_CAPTURE_16(command_polyline, point_count)};
+  NK_GLOBAL const capture_field capture_text[] = {
+      NK_CAPTURE_COLOR(command_text, background), NK_CAPTURE_COLOR(command_text, foreground),
+      NK_CAPTURE_RECT(command_text), NK_CAPTURE_32(command_text, height), NK_CAPTURE_32(command_text, length)};
+  NK_GLOBAL const capture_field capture_image[] = {
+      NK_CAPTURE_RECT(command_image), NK_CAPTURE_16(command_image, img.w), NK_CAPTURE_16(command_image, img.h),
+      {(std::uint16_t) (offsetof(command_image, img) + offsetof(struct image, region)), capture_field_type::FIELD_16},
+      {(std::uint16_t) (offsetof(command_image, img) + offsetof(struct image, region) + 2), capture_field_type::FIELD_16},
+      {(std::uint16_t) (offsetof(command_image, img) + offsetof(struct image, region) + 4), capture_field_type::FIELD_16},
+      {(std::uint16_t) (offsetof(command_image, img) + offsetof(struct image, region) + 6), capture_field_type::FIELD_16},
+      NK_CAPTURE_COLOR(command_image, col)};
+
+  INTERN const capture_field*
+  capture_fields(const command_type type, int* count) {
+#define NK_CAPTURE_CASE(t, fields) \
+  case command_type::t:            \
+    *count = (int) NK_LEN(fields); \
+    return fields;
+    switch (type) {
+      NK_CAPTURE_CASE(COMMAND_SCISSOR, capture_scissor)
+      NK_CAPTURE_CASE(COMMAND_LINE, capture_line)
+      NK_CAPTURE_CASE(COMMAND_CURVE, capture_curve)
+      NK_CAPTURE_CASE(COMMAND_RECT, capture_rect)
+      NK_CAPTURE_CASE(COMMAND_RECT_FILLED, capture_rect_filled)
+      NK_CAPTURE_CASE(COMMAND_RECT_MULTI_COLOR, capture_rect_multi_color)
+      NK_CAPTURE_CASE(COMMAND_CIRCLE, capture_circle)
+      NK_CAPTURE_CASE(COMMAND_CIRCLE_FILLED, capture_circle_filled)
+      NK_CAPTURE_CASE(COMMAND_ARC, capture_arc)
+      NK_CAPTURE_CASE(COMMAND_ARC_FILLED, capture_arc_filled)
+      NK_CAPTURE_CASE(COMMAND_TRIANGLE, capture_triangle)
+      NK_CAPTURE_CASE(COMMAND_TRIANGLE_FILLED, capture_triangle_filled)
+      NK_CAPTURE_CASE(COMMAND_POLYGON, capture_polygon)
+      NK_CAPTURE_CASE(COMMAND_POLYGON_FILLED, capture_polygon_filled)
+      NK_CAPTURE_CASE(COMMAND_POLYLINE, capture_polyline)
+      NK_CAPTURE_CASE(COMMAND_TEXT, capture_text)
+      NK_CAPTURE_CASE(COMMAND_IMAGE, capture_image)
+      default:
+        /* custom commands point to callbacks of the capturing process */
+        *count = 0;
+        return 0;
+    }
+#undef NK_CAPTURE_CASE
+  }
+  INTERN void
+  capture_store(std::uint8_t* dst, const std::uint64_t value, const int bytes) {
+    for (int i = 0; i < bytes; ++i)
+      dst[i] = (std::uint8_t) (value >> (8 * i));
+  }
+  INTERN std::uint64_t
+  capture_load(const std::uint8_t* src, const int bytes) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i)
+      value |= (std::uint64_t) src[i] << (8 * i);
+    return value;
+  }
+  INTERN int
+  capture_field_size(const capture_field_type type) {
+    return type == capture_field_type::FIELD_16 ? 2 : 4;
+  }
+  INTERN std::size_t
+  capture_encode_fields(std::uint8_t* dst, const command* cmd, const capture_field* fields, const int count) {
+    const std::uint8_t* src = (const std::uint8_t*) cmd;
+    std::size_t size = 0;
+    for (int i = 0; i < count; ++i) {
+      const std::uint8_t* field = src + fields[i].offset;
+      if (fields[i].type == capture_field_type::FIELD_16) {
+        std::uint16_t v;
+        std::memcpy(&v, field, sizeof(v));
+        capture_store(dst + size, v, 2);
+      } else if (fields[i].type == capture_field_type::FIELD_32) {
+        std::uint32_t v;
+        std::memcpy(&v, field, sizeof(v));
+        capture_store(dst + size, v, 4);
+      } else {
+        std::memcpy(dst + size, field, 4);
+      }
+      size += (std::size_t) capture_field_size(fields[i].type);
+    }
+    return size;
+  }
+  INTERN std::size_t
+  capture_decode_fields(command* cmd, const std::uint8_t* src, const capture_field* fields, const int count) {
+    std::uint8_t* dst = (std::uint8_t*) cmd;
+    std::size_t size = 0;
+    for (int i = 0; i < count; ++i) {
+      std::uint8_t* field = dst + fields[i].offset;
+      if (fields[i].type == capture_field_type::FIELD_16) {
+        const std::uint16_t v = (std::uint16_t) capture_load(src + size, 2);
+        std::memcpy(field, &v, sizeof(v));
+      } else if (fields[i].type == capture_field_type::FIELD_32) {
+        const std::uint32_t v = (std::uint32_t) capture_load(src + size, 4);
+        std::memcpy(field, &v, sizeof(v));
+      } else {
+        std::memcpy(field, src + size, 4);
+      }
+      size += (std::size_t) capture_field_size(fields[i].type);
+    }
+    return size;
+  }
+  INTERN std::size_t
+  capture_fields_size(const capture_field* fields, const int count) {
+    std::size_t size = 0;
+    for (int i = 0; i < count; ++i)
+      size += (std::size_t) capture_field_size(fields[i].type);
+    return size;
+  }
+  INTERN bool
+  capture_write_bytes(memory_buffer* out, const void* data, const std::size_t size) {
+    if (!size)
+      return true;
+    void* dst = buffer_alloc(out, buffer_allocation_type::BUFFER_FRONT, size, 1);
+    if (!dst)
+      return false;
+    std::memcpy(dst, data, size);
+    return true;
+  }
+  INTERN std::uint32_t
+  capture_table_index(memory_buffer* table, const void* key, const std::size_t size) {
+    /* handle tables are small, a linear search keeps them in first use order */
+    const std::uint8_t* entries = (const std::uint8_t*) buffer_memory_const(table);
+    const std::uint32_t count = (std::uint32_t) (table->allocated / size);
+    for (std::uint32_t i = 0; i < count; ++i) {
+      if (!std::memcmp(entries + i * size, key, size))
+        return i;
+    }
+    if (!capture_write_bytes(table, key, size))
+      return UINT32_MAX;
+    return count;
+  }
+  NK_API void
+  capture_writer_init(struct capture_writer* writer, const struct allocator* alloc) {
+    NK_ASSERT(writer);
+    NK_ASSERT(alloc);
+    if (!writer || !alloc)
+      return;
+    zero_struct(*writer);
+    buffer_init(&writer->fonts, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    buffer_init(&writer->images, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  }
+  NK_API void
+  capture_writer_free(struct capture_writer* writer) {
+    NK_ASSERT(writer);
+    if (!writer)
+      return;
+    buffer_free(&writer->fonts);
+    buffer_free(&writer->images);
+    zero_struct(*writer);
+  }
+  INTERN std::size_t
+  capture_point_count(const command* cmd) {
+    switch (cmd->type) {
+      case command_type::COMMAND_POLYGON:
+        return ((const command_polygon*) cmd)->point_count;
+      case command_type::COMMAND_POLYGON_FILLED:
+        return ((const command_polygon_filled*) cmd)->point_count;
+      case command_type::COMMAND_POLYLINE:
+        return ((const command_polyline*) cmd)->point_count;
+      default:
+        return 0;
+    }
+  }
+  INTERN vec2i*
+  capture_points(command* cmd) {
+    switch (cmd->type) {
+      case command_type::COMMAND_POLYGON:
+        return ((command_polygon*) cmd)->points;
+      case command_type::COMMAND_POLYGON_FILLED:
+        return ((command_polygon_filled*) cmd)->points;
+      case command_type::COMMAND_POLYLINE:
+        return ((command_polyline*) cmd)->points;
+      default:
+        return 0;
+    }
+  }
+  INTERN bool
+  capture_write_record(struct capture_writer* writer, memory_buffer* out, const command* cmd) {
+    std::uint8_t record[128];
+    int count;
+    const capture_field* fields = capture_fields(cmd->type, &count);
+    const std::size_t points = capture_point_count(cmd);
+    std::size_t size = capture_record_header_size;
+    std::size_t text = 0;
+
+    record[0] = (std::uint8_t) cmd->type;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    {
+      std::uint64_t userdata = 0;
+      std::memcpy(&userdata, &cmd->userdata, sizeof(cmd->userdata));
+      capture_store(record + size, userdata, 8);
+      size += 8;
+    }
+#endif
+    if (cmd->type == command_type::COMMAND_TEXT) {
+      const command_text* t = (const command_text*) cmd;
+      const std::uint32_t font = capture_table_index(&writer->fonts, &t->font, sizeof(t->font));
+      if (font == UINT32_MAX)
+        return false;
+      capture_store(record + size, font, 4);
+      size += 4;
+      text = (std::size_t) t->length;
+    } else if (cmd->type == command_type::COMMAND_IMAGE) {
+      const command_image* i = (const command_image*) cmd;
+      const std::uint32_t img = capture_table_index(&writer->images, &i->img.handle, sizeof(i->img.handle));
+      if (img == UINT32_MAX)
+        return false;
+      capture_store(record + size, img, 4);
+      size += 4;
+    }
+    size += capture_encode_fields(record + size, cmd, fields, count);
+    capture_store(record + 1, size - capture_record_header_size + text + points * 4, 4);
+    if (!capture_write_bytes(out, record, size))
+      return false;
+    if (text && !capture_write_bytes(out, ((const command_text*) cmd)->string, text))
+      return false;
+    if (points) {
+      std::uint8_t* dst = (std::uint8_t*) buffer_alloc(out, buffer_allocation_type::BUFFER_FRONT, points * 4, 1);
+      if (!dst)
+        return false;
+      const vec2i* src = capture_points((command*) cmd);
+      for (std::size_t i = 0; i < points; ++i, dst += 4) {
+        capture_store(dst, (std::uint16_t) src[i].x, 2);
+        capture_store(dst + 2, (std::uint16_t) src[i].y, 2);
+      }
+    }
+    return true;
+  }
+  INTERN bool
+  capture_write_tables(const struct capture_writer* writer, memory_buffer* out,
+                       const std::uint32_t first_font, const std::uint32_t first_image) {
+    /* appends the table entries from the given indices on */
+    const std::uint32_t font_count = (std::uint32_t) (writer->fonts.allocated / sizeof(const user_font*));
+    const user_font* const* font_table = (const user_font* const*) buffer_memory_const(&writer->fonts);
+    for (std::uint32_t i = first_font; i < font_count; ++i) {
+      std::uint8_t entry[4];
+      std::uint32_t height;
+      std::memcpy(&height, &font_table[i]->height, sizeof(height));
+      capture_store(entry, height, 4);
+      if (!capture_write_bytes(out, entry, sizeof(entry)))
+        return false;
+    }
+    const std::uint32_t image_count = (std::uint32_t) (writer->images.allocated / sizeof(resource_handle));
+    const resource_handle* image_table = (const resource_handle*) buffer_memory_const(&writer->images);
+    for (std::uint32_t i = first_image; i < image_count; ++i) {
+      std::uint8_t entry[8];
+      std::uint64_t handle = 0;
+      std::memcpy(&handle, &image_table[i], sizeof(image_table[i]));
+      capture_store(entry, handle, 8);
+      if (!capture_write_bytes(out, entry, sizeof(entry)))
+        return false;
+    }
+    return true;
+  }
+  INTERN void
+  capture_store_header(std::uint8_t* header, const unsigned int flags, const std::uint32_t commands,
+                       const std::uint32_t font_count, const std::uint32_t image_count, const std::size_t records) {
+    const std::size_t fonts = capture_header_size + records;
+    const std::size_t images = fonts + (std::size_t) font_count * 4;
+    capture_store(header, capture_magic, 4);
+    capture_store(header + 4, NK_CAPTURE_VERSION, 2);
+    capture_store(header + 6, flags, 2);
+    capture_store(header + 8, commands, 4);
+    capture_store(header + 12, font_count, 4);
+    capture_store(header + 16, image_count, 4);
+    capture_store(header + 20, capture_header_size, 4);
+    capture_store(header + 24, fonts, 4);
+    capture_store(header + 28, images, 4);
+    capture_store(header + 32, images + (std::size_t) image_count * 8, 4);
+  }
+  INTERN unsigned int
+  capture_default_flags() {
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    return capture_flag_userdata;
+#else
+    return 0;
+#endif
+  }
+  INTERN std::uint32_t
+  capture_font_count(const struct capture_writer* writer) {
+    return (std::uint32_t) (writer->fonts.allocated / sizeof(const user_font*));
+  }
+  INTERN std::uint32_t
+  capture_image_count(const struct capture_writer* writer) {
+    return (std::uint32_t) (writer->images.allocated / sizeof(resource_handle));
+  }
+  INTERN bool
+  capture_rollback(memory_buffer* out, const std::size_t begin) {
+    /* drop the partial frame so `out` still ends with the last complete one */
+    out->allocated = begin;
+    return false;
+  }
+  NK_API bool
+  capture_write(struct capture_writer* writer, context* ctx, memory_buffer* out) {
+    std::uint32_t commands = 0;
+    const command* cmd;
+
+    NK_ASSERT(writer);
+    NK_ASSERT(ctx);
+    NK_ASSERT(out);
+    if (!writer || !ctx || !out)
+      return false;
+
+    /* frames can be appended to each other, offsets are relative to the header */
+    buffer_clear(&writer->fonts);
+    buffer_clear(&writer->images);
+    const std::size_t begin = out->allocated;
+    if (!buffer_alloc(out, buffer_allocation_type::BUFFER_FRONT, capture_header_size, 1))
+      return false;
+    foreach (cmd, ctx) {
+      int count;
+      if (!capture_fields(cmd->type, &count))
+        continue;
+      if (!capture_write_record(writer, out, cmd))
+        return capture_rollback(out, begin);
+      commands++;
+    }
+    const std::size_t records = out->allocated - begin - capture_header_size;
+    if (!capture_write_tables(writer, out, 0, 0))
+      return capture_rollback(out, begin);
+    capture_store_header((std::uint8_t*) buffer_memory(out) + begin, capture_default_flags(), commands,
+                         capture_font_count(writer), capture_image_count(writer), records);
+    return true;
+  }
+  NK_API bool
+  capture_reader_init(struct capture_reader* reader, const void* data, const std::size_t size) {
+    NK_ASSERT(reader);
+    NK_ASSERT(data);
+    if (!reader || !data)
+      return false;
+    zero_struct(*reader);
+    if (size < capture_header_size)
+      return false;
+
+    const std::uint8_t* header = (const std::uint8_t*) data;
+    if (capture_load(header, 4) != capture_magic || capture_load(header + 4, 2) != NK_CAPTURE_VERSION)
+      return false;
+    reader->data = header;
+    reader->flags = (unsigned int) capture_load(header + 6, 2);
+    reader->command_count = (unsigned int) capture_load(header + 8, 4);
+    reader->font_count = (unsigned int) capture_load(header + 12, 4);
+    reader->image_count = (unsigned int) capture_load(header + 16, 4);
+    reader->records = (std::size_t) capture_load(header + 20, 4);
+    reader->fonts = (std::size_t) capture_load(header + 24, 4);
+    reader->images = (std::size_t) capture_load(header + 28, 4);
+    reader->size = (std::size_t) capture_load(header + 32, 4);
+
+    /* sections have to be in order and inside the frame */
+    if (reader->size > size || reader->records < capture_header_size || reader->records > reader->fonts ||
+        reader->fonts + (std::size_t) reader->font_count * 4 != reader->images ||
+        reader->images + (std::size_t) reader->image_count * 8 != reader->size) {
+      zero_struct(*reader);
+      return false;
+    }
+    return true;
+  }
+  NK_API float
+  capture_font_height(const struct capture_reader* reader, const unsigned int index) {
+    NK_ASSERT(reader);
+    if (!reader || index >= reader->font_count)
+      return 0;
+    const std::uint32_t bits = (std::uint32_t) capture_load(reader->data + reader->fonts + index * 4, 4);
+    float height;
+    std::memcpy(&height, &bits, sizeof(height));
+    return height;
+  }
+  NK_API resource_handle
+  capture_image_handle(const struct capture_reader* reader, const unsigned int index) {
+    resource_handle handle;
+    zero_struct(handle);
+    NK_ASSERT(reader);
+    if (!reader || index >= reader->image_count)
+      return handle;
+    const std::uint64_t bits = capture_load(reader->data + reader->images + index * 8, 8);
+    std::memcpy(&handle, &bits, sizeof(handle));
+    return handle;
+  }
+  INTERN bool
+  capture_replay_record(const struct capture_reader* reader, const struct capture_bindings* bindings,
+                        command_buffer* out, const command_type type, const std::uint8_t* src, std::size_t size) {
+    int count;
+    const capture_field* fields = capture_fields(type, &count);
+    if (!fields)
+      return true;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    resource_handle userdata;
+    zero_struct(userdata);
+#endif
+    if (reader->flags & capture_flag_userdata) {
+      if (size < 8)
+        return false;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+      const std::uint64_t bits = capture_load(src, 8);
+      std::memcpy(&userdata, &bits, sizeof(userdata));
+#endif
+      src += 8;
+      size -= 8;
+    }
+
+    std::uint32_t index = 0;
+    if (type == command_type::COMMAND_TEXT || type == command_type::COMMAND_IMAGE) {
+      if (size < 4)
+        return false;
+      index = (std::uint32_t) capture_load(src, 4);
+      src += 4;
+      size -= 4;
+    }
+    const std::size_t fixed = capture_fields_size(fields, count);
+    if (size < fixed)
+      return false;
+
+    /* decode the fixed part first to know how large the command is */
+    union {
+      command_text text;
+      command_image image;
+      command_polygon polygon;
+      command_curve curve;
+      command_rect_multi_color multi_color;
+      command_arc arc;
+      command_triangle triangle;
+    } tmp;
+    zero_struct(tmp);
+    command* decoded = (command*) &tmp;
+    decoded->type = type;
+    capture_decode_fields(decoded, src, fields, count);
+    src += fixed;
+    size -= fixed;
+
+    std::size_t bytes = command_size(decoded);
+    const std::size_t points = capture_point_count(decoded);
+    if (type == command_type::COMMAND_TEXT) {
+      if (tmp.text.length <= 0 || (std::size_t) tmp.text.length != size)
+        return false;
+      if (!bindings || index >= bindings->font_count || !bindings->fonts[index])
+        return true; /* text without a font cannot be measured or drawn */
+      tmp.text.font = bindings->fonts[index];
+      bytes = sizeof(command_text) + size + 1;
+    } else if (type == command_type::COMMAND_IMAGE) {
+      if (bindings && index < bindings->image_count)
+        tmp.image.img.handle = bindings->images[index];
+      else
+        tmp.image.img.handle = capture_image_handle(reader, index);
+    } else if (points && size != points * 4) {
+      return false;
+    }
+
+    command* cmd = (command*) command_buffer_push(out, type, bytes);
+    if (!cmd)
+      return false;
+    const std::size_t next = cmd->next;
+    std::memcpy(cmd, decoded, std::min(bytes, sizeof(tmp)));
+    cmd->next = next;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    cmd->userdata = userdata;
+#endif
+    if (type == command_type::COMMAND_TEXT) {
+      command_text* t = (command_text*) cmd;
+      std::memcpy(t->string, src, size);
+      t->string[size] = '\0';
+    } else if (points) {
+      vec2i* dst = capture_points(cmd);
+      for (std::size_t i = 0; i < points; ++i, src += 4) {
+        dst[i].x = (short) capture_load(src, 2);
+        dst[i].y = (short) capture_load(src + 2, 2);
+      }
+    }
+    return true;
+  }
+  NK_API bool
+  capture_replay(const struct capture_reader* reader, const struct capture_bindings* bindings, memory_buffer* out) {
+    command_buffer cb;
+    NK_ASSERT(reader);
+    NK_ASSERT(out);
+    if (!reader || !reader->data || !out)
+      return false;
+
+    buffer_clear(out);
+    command_buffer_init(&cb, out, NK_CLIPPING_OFF);
+    std::size_t offset = reader->records;
+    for (unsigned int i = 0; i < reader->command_count; ++i) {
+      if (offset + capture_record_header_size > reader->fonts)
+        return false;
+      const std::uint8_t* record = reader->data + offset;
+      const std::size_t size = (std::size_t) capture_load(record + 1, 4);
+      offset += capture_record_header_size;
+      if (size > reader->fonts - offset)
+        return false;
+      /* unknown types from newer writers are skipped */
+      if (!capture_replay_record(reader, bindings, &cb, (command_type) record[0], reader->data + offset, size))
+        return false;
+      offset += size;
+    }
+    return true;
+  }
+  /* ===============================================================
+   *
+   *                              STREAM
+   *
+   * ===============================================================*/
+  /*  message layout, all values little endian:
+   *
+   *  header   u32 magic, u16 version, u16 flags, u32 message size, u32 frame,
+   *           u32 window count, u32 new font count, u32 new image count
+   *  windows  u32 name, u8 op followed by the op data, in drawing order
+   *  tables   font and image table entries added since the last message
+   *
+   *  STREAM_WINDOW_KEEP   nothing, the window records of the previous frame
+   *  STREAM_WINDOW_EDIT   u32 kept leading records, u32 kept trailing records,
+   *                       u32 new record count, u32 new record bytes, records
+   *  STREAM_WINDOW_FULL   u32 record count, u32 record bytes, records
+   *
+   *  Records and tables use the capture format. Table indices stay valid
+   *  until the next key frame. */
+  NK_GLOBAL constexpr std::uint32_t stream_magic = 0x44534B4E; /* "NKSD" */
+  NK_GLOBAL constexpr std::size_t stream_header_size = 28;
+  NK_GLOBAL constexpr unsigned int stream_flag_key_frame = 2;
+
+  enum class stream_window_op : std::uint8_t {
+    STREAM_WINDOW_KEEP,
+    STREAM_WINDOW_EDIT,
+    STREAM_WINDOW_FULL
+  };
+
+  INTERN std::size_t
+  capture_record_size(const std::uint8_t* record) {
+    return capture_record_header_size + (std::size_t) capture_load(record + 1, 4);
+  }
+  INTERN void
+  stream_frame_init(struct stream_frame* frame, const struct allocator* alloc) {
+    buffer_init(&frame->records, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    buffer_init(&frame->windows, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    frame->window_count = 0;
+    frame->command_count = 0;
+  }
+  INTERN void
+  stream_frame_clear(struct stream_frame* frame) {
+    buffer_clear(&frame->records);
+    buffer_clear(&frame->windows);
+    frame->window_count = 0;
+    frame->command_count = 0;
+  }
+  INTERN void
+  stream_frame_free(struct stream_frame* frame) {
+    buffer_free(&frame->records);
+    buffer_free(&frame->windows);
+  }
+  INTERN const struct stream_window*
+  stream_find_window(const struct stream_frame* frame, const hash name) {
+    const struct stream_window* windows = (const struct stream_window*) buffer_memory_const(&frame->windows);
+    for (unsigned int i = 0; i < frame->window_count; ++i) {
+      if (windows[i].name == name)
+        return &windows[i];
+    }
+    return 0;
+  }
+  INTERN bool
+  stream_push_window(struct stream_frame* frame, const struct stream_window* win) {
+    struct stream_window* dst = (struct stream_window*) buffer_alloc(&frame->windows, buffer_allocation_type::BUFFER_FRONT,
+                                                                     sizeof(*dst), alignof(struct stream_window));
+    if (!dst)
+      return false;
+    *dst = *win;
+    frame->window_count++;
+    frame->command_count += win->count;
+    return true;
+  }
+  INTERN bool
+  stream_record_offsets(memory_buffer* scratch, const std::uint8_t* records, const struct stream_window* win,
+                        std::size_t** offsets) {
+    /* offsets of every record plus the end of the last one */
+    std::size_t* dst = (std::size_t*) buffer_alloc(scratch, buffer_allocation_type::BUFFER_FRONT,
+                                                   sizeof(std::size_t) * (win->count + 1), alignof(std::size_t));
+    if (!dst)
+      return false;
+    std::size_t offset = win->offset;
+    for (unsigned int i = 0; i < win->count; ++i) {
+      dst[i] = offset;
+      offset += capture_record_size(records + offset);
+    }
+    dst[win->count] = offset;
+    *offsets = dst;
+    return true;
+  }
+  INTERN bool
+  stream_records_equal(const std::uint8_t* a, const std::size_t* a_offsets, const unsigned int i,
+                       const std::uint8_t* b, const std::size_t* b_offsets, const unsigned int j) {
+    const std::size_t size = a_offsets[i + 1] - a_offsets[i];
+    return size == b_offsets[j + 1] - b_offsets[j] && !std::memcmp(a + a_offsets[i], b + b_offsets[j], size);
+  }
+  INTERN bool
+  stream_write_window(struct stream_encoder* enc, memory_buffer* out, const struct stream_frame* prev,
+                      const struct stream_window* old, const struct stream_frame* next, const struct stream_window* win) {
+    const std::uint8_t* old_records = (const std::uint8_t*) buffer_memory_const(&prev->records);
+    const std::uint8_t* records = (const std::uint8_t*) buffer_memory_const(&next->records);
+    std::uint8_t data[21];
+    std::size_t size = 5;
+
+    capture_store(data, win->name, 4);
+    if (old && old->size == win->size && !std::memcmp(old_records + old->offset, records + win->offset, win->size)) {
+      data[4] = (std::uint8_t) stream_window_op::STREAM_WINDOW_KEEP;
+      return capture_write_bytes(out, data, size);
+    }
+
+    unsigned int front = 0, back = 0;
+    std::size_t begin = win->offset, end = win->offset + win->size;
+    if (old && old->count && win->count) {
+      /* keep the records both frames start and end with, send the rest */
+      std::size_t *old_offsets, *offsets;
+      buffer_clear(&enc->scratch);
+      if (!stream_record_offsets(&enc->scratch, old_records, old, &old_offsets) ||
+          !stream_record_offsets(&enc->scratch, records, win, &offsets))
+        return false;
+      const unsigned int common = std::min(old->count, win->count);
+      while (front < common && stream_records_equal(old_records, old_offsets, front, records, offsets, front))
+        front++;
+      while (back < common - front &&
+             stream_records_equal(old_records, old_offsets, old->count - 1 - back, records, offsets, win->count - 1 - back))
+        back++;
+      begin = offsets[front];
+      end = offsets[win->count - back];
+    }
+    if (front || back) {
+      data[4] = (std::uint8_t) stream_window_op::STREAM_WINDOW_EDIT;
+      capture_store(data + size, front, 4);
+      capture_store(data + size + 4, back, 4);
+      size += 8;
+    } else {
+      data[4] = (std::uint8_t) stream_window_op::STREAM_WINDOW_FULL;
+    }
+    capture_store(data + size, win->count - front - back, 4);
+    capture_store(data + size + 4, end - begin, 4);
+    size += 8;
+    return capture_write_bytes(out, data, size) && capture_write_bytes(out, records + begin, end - begin);
+  }
+  INTERN bool
+  stream_write_range(struct stream_encoder* enc, struct stream_frame* frame, const context* ctx,
+                     std::size_t offset, const std::size_t last, unsigned int* count) {
+    const std::uint8_t* buffer = (const std::uint8_t*) ctx->memory.memory.ptr;
+    while (1) {
+      const command* cmd = ptr_add_const(command, buffer, offset);
+      int fields;
+      if (capture_fields(cmd->type, &fields)) {
+        if (!capture_write_record(&enc->tables, &frame->records, cmd))
+          return false;
+        (*count)++;
+      }
+      if (offset == last || cmd->next <= offset || cmd->next >= ctx->memory.allocated)
+        break;
+      offset = cmd->next;
+    }
+    return true;
+  }
+  INTERN bool
+  stream_encode_window(struct stream_encoder* enc, memory_buffer* out, const context* ctx,
+                       const hash name, const std::size_t begin, const std::size_t last) {
+    /* records are always encoded again, `stream_write_window` compares them
+     * byte for byte with the previous frame */
+    const struct stream_frame* prev = &enc->frames[enc->current];
+    struct stream_frame* next = &enc->frames[!enc->current];
+    const struct stream_window* old = stream_find_window(prev, name);
+    struct stream_window win;
+    win.name = name;
+    win.offset = next->records.allocated;
+    win.count = 0;
+    if (!stream_write_range(enc, next, ctx, begin, last, &win.count))
+      return false;
+    win.size = next->records.allocated - win.offset;
+    return stream_write_window(enc, out, prev, old, next, &win) && stream_push_window(next, &win);
+  }
+  NK_API void
+  stream_encoder_init(struct stream_encoder* enc, const struct allocator* alloc) {
+    NK_ASSERT(enc);
+    NK_ASSERT(alloc);
+    if (!enc || !alloc)
+      return;
+    zero_struct(*enc);
+    capture_writer_init(&enc->tables, alloc);
+    stream_frame_init(&enc->frames[0], alloc);
+    stream_frame_init(&enc->frames[1], alloc);
+    buffer_init(&enc->scratch, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  }
+  NK_API void
+  stream_encoder_reset(struct stream_encoder* enc) {
+    NK_ASSERT(enc);
+    if (!enc)
+      return;
+    enc->valid = false;
+  }
+  NK_API void
+  stream_encoder_free(struct stream_encoder* enc) {
+    NK_ASSERT(enc);
+    if (!enc)
+      return;
+    capture_writer_free(&enc->tables);
+    stream_frame_free(&enc->frames[0]);
+    stream_frame_free(&enc->frames[1]);
+    buffer_free(&enc->scratch);
+    zero_struct(*enc);
+  }
+  NK_API bool
+  stream_encode(struct stream_encoder* enc, context* ctx, memory_buffer* out) {
+    NK_ASSERT(enc);
+    NK_ASSERT(ctx);
+    NK_ASSERT(out);
+    if (!enc || !ctx || !out)
+      return false;
+    if (!ctx->build) {
+      build(ctx);
+      ctx->build = true;
+    }
+
+    const bool key = !enc->valid;
+    if (key) {
+      buffer_clear(&enc->tables.fonts);
+      buffer_clear(&enc->tables.images);
+      enc->fonts_sent = 0;
+      enc->images_sent = 0;
+      stream_frame_clear(&enc->frames[enc->current]);
+    }
+    /* a failed frame leaves tables the decoder never saw, so start over */
+    enc->valid = false;
+    stream_frame_clear(&enc->frames[!enc->current]);
+
+    const std::size_t begin = out->allocated;
+    if (!buffer_alloc(out, buffer_allocation_type::BUFFER_FRONT, stream_header_size, 1))
+      return false;
+    for (const window* it = ctx->begin; ctx->count && it; it = it->next) {
+      if (it->buffer.last == it->buffer.begin || (it->flags & static_cast<decltype(it->flags)>(window_flags::WINDOW_HIDDEN)) ||
+          it->seq != ctx->seq)
+        continue;
+      if (!stream_encode_window(enc, out, ctx, it->name, it->buffer.begin, it->buffer.last))
+        return capture_rollback(out, begin);
+    }
+    /* popups and the overlay are linked behind the last window in window order,
+     * their memory may lie before their predecessor so each range is encoded on its own */
+    for (const window* it = ctx->begin; ctx->count && it; it = it->next) {
+      if (!it->popup.buf.linked)
+        continue;
+      const hash name = murmur_hash(&it->popup.name, (int) sizeof(it->popup.name), it->name);
+      if (!stream_encode_window(enc, out, ctx, name, it->popup.buf.begin, it->popup.buf.last))
+        return capture_rollback(out, begin);
+    }
+    if (ctx->overlay.end != ctx->overlay.begin &&
+        !stream_encode_window(enc, out, ctx, 0, ctx->overlay.begin, ctx->overlay.last))
+      return capture_rollback(out, begin);
+
+    const std::uint32_t fonts = capture_font_count(&enc->tables);
+    const std::uint32_t images = capture_image_count(&enc->tables);
+    if (!capture_write_tables(&enc->tables, out, enc->fonts_sent, enc->images_sent))
+      return capture_rollback(out, begin);
+
+    std::uint8_t* header = (std::uint8_t*) buffer_memory(out) + begin;
+    capture_store(header, stream_magic, 4);
+    capture_store(header + 4, NK_CAPTURE_VERSION, 2);
+    capture_store(header + 6, capture_default_flags() | (key ? stream_flag_key_frame : 0), 2);
+    capture_store(header + 8, out->allocated - begin, 4);
+    capture_store(header + 12, enc->frame, 4);
+    capture_store(header + 16, enc->frames[!enc->current].window_count, 4);
+    capture_store(header + 20, fonts - enc->fonts_sent, 4);
+    capture_store(header + 24, images - enc->images_sent, 4);
+
+    enc->fonts_sent = fonts;
+    enc->images_sent = images;
+    enc->current = !enc->current;
+    enc->frame++;
+    enc->valid = true;
+    return true;
+  }
+  NK_API std::size_t
+  stream_message_size(const void* data, const std::size_t size) {
+    const std::uint8_t* header = (const std::uint8_t*) data;
+    if (!data || size < stream_header_size || capture_load(header, 4) != stream_magic)
+      return 0;
+    return (std::size_t) capture_load(header + 8, 4);
+  }
+  NK_API void
+  stream_decoder_init(struct stream_decoder* dec, const struct allocator* alloc) {
+    NK_ASSERT(dec);
+    NK_ASSERT(alloc);
+    if (!dec || !alloc)
+      return;
+    zero_struct(*dec);
+    buffer_init(&dec->fonts, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    buffer_init(&dec->images, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    stream_frame_init(&dec->frames[0], alloc);
+    stream_frame_init(&dec->frames[1], alloc);
+    buffer_init(&dec->capture, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  }
+  NK_API void
+  stream_decoder_free(struct stream_decoder* dec) {
+    NK_ASSERT(dec);
+    if (!dec)
+      return;
+    buffer_free(&dec->fonts);
+    buffer_free(&dec->images);
+    stream_frame_free(&dec->frames[0]);
+    stream_frame_free(&dec->frames[1]);
+    buffer_free(&dec->capture);
+    zero_struct(*dec);
+  }
+  INTERN bool
+  stream_skip_records(const std::uint8_t* records, const struct stream_window* win,
+                      const unsigned int count, std::size_t* offset) {
+    /* offset behind the first `count` records of a window */
+    const std::size_t end = win->offset + win->size;
+    *offset = win->offset;
+    for (unsigned int i = 0; i < count; ++i) {
+      if (*offset + capture_record_header_size > end)
+        return false;
+      *offset += capture_record_size(records + *offset);
+    }
+    return *offset <= end;
+  }
+  INTERN bool
+  stream_decode_window(struct stream_decoder* dec, const std::uint8_t** data, const std::uint8_t* end) {
+    const struct stream_frame* prev = &dec->frames[dec->current];
+    struct stream_frame* next = &dec->frames[!dec->current];
+    const std::uint8_t* old_records = (const std::uint8_t*) buffer_memory_const(&prev->records);
+    const std::uint8_t* p = *data;
+    struct stream_window win;
+
+    if (end - p < 5)
+      return false;
+    zero_struct(win);
+    win.name = (hash) capture_load(p, 4);
+    win.offset = next->records.allocated;
+    const stream_window_op op = (stream_window_op) p[4];
+    const struct stream_window* old = stream_find_window(prev, win.name);
+    p += 5;
+
+    std::uint32_t front = 0, back = 0;
+    switch (op) {
+      case stream_window_op::STREAM_WINDOW_KEEP:
+        if (!old || !capture_write_bytes(&next->records, old_records + old->offset, old->size))
+          return false;
+        win.count = old->count;
+        break;
+      case stream_window_op::STREAM_WINDOW_EDIT:
+        if (end - p < 8 || !old)
+          return false;
+        front = (std::uint32_t) capture_load(p, 4);
+        back = (std::uint32_t) capture_load(p + 4, 4);
+        p += 8;
+        if ((std::size_t) front + back > old->count)
+          return false;
+        [[fallthrough]];
+      case stream_window_op::STREAM_WINDOW_FULL: {
+        if (end - p < 8)
+          return false;
+        const std::uint32_t count = (std::uint32_t) capture_load(p, 4);
+        const std::size_t size = (std::size_t) capture_load(p + 4, 4);
+        p += 8;
+        if ((std::size_t) (end - p) < size)
+          return false;
+        std::size_t front_end = 0, back_begin = 0;
+        if ((front || back) && (!stream_skip_records(old_records, old, front, &front_end) ||
+                    !stream_skip_records(old_records, old, old->count - back, &back_begin)))
+          return false;
+        if ((front && !capture_write_bytes(&next->records, old_records + old->offset, front_end - old->offset)) ||
+            !capture_write_bytes(&next->records, p, size) ||
+            (back && !capture_write_bytes(&next->records, old_records + back_begin, old->offset + old->size - back_begin)))
+          return false;
+        win.count = front + count + back;
+        p += size;
+      } break;
+      default:
+        return false;
+    }
+    win.size = next->records.allocated - win.offset;
+    *data = p;
+    return stream_push_window(next, &win);
+  }
+  NK_API bool
+  stream_decode(struct stream_decoder* dec, const void* data, const std::size_t size,
+                const struct capture_bindings* bindings, memory_buffer* out) {
+    struct capture_reader reader;
+    NK_ASSERT(dec);
+    NK_ASSERT(data);
+    NK_ASSERT(out);
+    if (!dec || !data || !out)
+      return false;
+
+    const std::uint8_t* header = (const std::uint8_t*) data;
+    const std::size_t message = stream_message_size(data, size);
+    if (message < stream_header_size || message > size || capture_load(header + 4, 2) != NK_CAPTURE_VERSION)
+      return false;
+    const unsigned int flags = (unsigned int) capture_load(header + 6, 2);
+    const std::uint32_t frame = (std::uint32_t) capture_load(header + 12, 4);
+    const std::uint32_t windows = (std::uint32_t) capture_load(header + 16, 4);
+    const std::uint32_t fonts = (std::uint32_t) capture_load(header + 20, 4);
+    const std::uint32_t images = (std::uint32_t) capture_load(header + 24, 4);
+    if (flags & stream_flag_key_frame) {
+      buffer_clear(&dec->fonts);
+      buffer_clear(&dec->images);
+      stream_frame_clear(&dec->frames[dec->current]);
+    } else if (!dec->valid || frame != (std::uint32_t) (dec->frame + 1)) {
+      /* differences without the frame they are based on, e.g. after a lost message */
+      dec->valid = false;
+      return false;
+    }
+    dec->valid = false;
+    stream_frame_clear(&dec->frames[!dec->current]);
+
+    const std::uint8_t* p = header + stream_header_size;
+    const std::uint8_t* end = header + message;
+    for (std::uint32_t i = 0; i < windows; ++i) {
+      if (!stream_decode_window(dec, &p, end))
+        return false;
+    }
+    if ((std::size_t) (end - p) != (std::size_t) fonts * 4 + (std::size_t) images * 8 ||
+        !capture_write_bytes(&dec->fonts, p, (std::size_t) fonts * 4) ||
+        !capture_write_bytes(&dec->images, p + (std::size_t) fonts * 4, (std::size_t) images * 8))
+      return false;
+
+    /* rebuild a capture frame out of the window records and the tables */
+    const struct stream_frame* next = &dec->frames[!dec->current];
+    buffer_clear(&dec->capture);
+    if (!buffer_alloc(&dec->capture, buffer_allocation_type::BUFFER_FRONT, capture_header_size, 1) ||
+        !capture_write_bytes(&dec->capture, buffer_memory_const(&next->records), next->records.allocated) ||
+        !capture_write_bytes(&dec->capture, buffer_memory_const(&dec->fonts), dec->fonts.allocated) ||
+        !capture_write_bytes(&dec->capture, buffer_memory_const(&dec->images), dec->images.allocated))
+      return false;
+    capture_store_header((std::uint8_t*) buffer_memory(&dec->capture), flags & capture_flag_userdata, next->command_count,
+                         (std::uint32_t) (dec->fonts.allocated / 4), (std::uint32_t) (dec->images.allocated / 8),
+                         next->records.allocated);
+    if (!capture_reader_init(&reader, buffer_memory_const(&dec->capture), dec->capture.allocated) ||
+        !capture_replay(&reader, bindings, out))
+      return false;
+    dec->current = !dec->current;
+    dec->frame = frame;
+    dec->valid = true;
+    return true;
+  }
+}
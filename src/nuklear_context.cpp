@@ -19,6 +19,7 @@ namespace nk {
       ctx->style.font = font;
 #ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
     draw_list_init(&ctx->draw_list);
+    ctx->draw_list.arcs = &ctx->arcs;
 #endif
   }
 #ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
@@ -58,7 +59,7 @@ namespace nk {
     } else {
       /* create dynamic pool from buffer allocator */
       const allocator* alloc = &pool->pool;
-      pool_init(&ctx->pool, alloc, NK_POOL_DEFAULT_CAPACITY);
+      pool_init(&ctx->pool, alloc);
     }
     ctx->use_pool = true;
     return 1;
@@ -71,7 +72,7 @@ namespace nk {
       return 0;
     setup(ctx, font);
     buffer_init(&ctx->memory, alloc, NK_DEFAULT_COMMAND_BUFFER_SIZE);
-    pool_init(&ctx->pool, alloc, NK_POOL_DEFAULT_CAPACITY);
+    pool_init(&ctx->pool, alloc);
     ctx->use_pool = true;
     return 1;
   }
@@ -91,8 +92,14 @@ namespace nk {
     if (!ctx)
       return;
     buffer_free(&ctx->memory);
-    if (ctx->use_pool)
+    if (ctx->use_pool) {
+      for (window* iter = ctx->begin; iter; iter = iter->next) {
+        free_value_index(ctx, iter);
+        if (iter->popup.win)
+          free_value_index(ctx, iter->popup.win);
+      }
       pool_free(&ctx->pool);
+    }
 
     zero(&ctx->input, sizeof(ctx->input));
     zero(&ctx->style, sizeof(ctx->style));
@@ -104,10 +111,47 @@ namespace nk {
     ctx->end = 0;
     ctx->active = 0;
     ctx->current = 0;
-    ctx->freelist = 0;
+    zero_struct(ctx->pool);
+    zero_struct(ctx->window_index);
     ctx->count = 0;
   }
   NK_API void
+  trim(context* ctx) {
+    NK_ASSERT(ctx);
+    if (!ctx || !ctx->use_pool)
+      return;
+    pool_trim(&ctx->pool);
+  }
+  NK_API void
+  memory_info(struct memory_stats* stats, const context* ctx) {
+    NK_ASSERT(stats);
+    NK_ASSERT(ctx);
+    if (!stats || !ctx)
+      return;
+    zero_struct(*stats);
+
+    buffer_usage(&stats->commands, &ctx->memory);
+    buffer_usage(&stats->text_edit, &ctx->text_edit.string.buffer);
+    for (unsigned int i = 0; i < stats->pools.size(); ++i)
+      pool_usage(&stats->pools[i], &ctx->pool, static_cast<page_type>(i));
+#ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+    stats->path.used = sizeof(vec2f) * ctx->draw_list.path_count;
+    stats->path.peak = sizeof(vec2f) * ctx->draw_list.path_peak;
+    stats->path.capacity = stats->path.used;
+#endif
+
+    for (const window* iter = ctx->begin; iter; iter = iter->next) {
+      stats->windows++;
+      stats->tables += iter->table_count;
+      stats->max_window_tables = std::max(stats->max_window_tables, iter->table_count);
+      if (iter->popup.win) {
+        stats->windows++;
+        stats->tables += iter->popup.win->table_count;
+        stats->max_window_tables = std::max(stats->max_window_tables, iter->popup.win->table_count);
+      }
+    }
+  }
+  NK_API void
   clear(context* ctx) {
     NK_ASSERT(ctx);
 
@@ -140,8 +184,11 @@ namespace nk {
           iter == ctx->active) {
         ctx->active = iter->prev;
         ctx->end = iter->prev;
-        if (!ctx->end)
+        if (!ctx->end) {
+          /* list got detached so its windows must not be found anymore */
           ctx->begin = 0;
+          zero_struct(ctx->window_index);
+        }
         if (ctx->active)
           ctx->active->flags &= ~static_cast<decltype(iter->flags)>(window_flags::WINDOW_ROM);
       }
@@ -151,20 +198,7 @@ namespace nk {
         iter->popup.win = 0;
       }
       /* remove unused window state tables */
-      {
-        table* it = iter->tables;
-        while (it) {
-          table* n = it->next;
-          if (it->seq != ctx->seq) {
-            remove_table(iter, it);
-            zero(it, sizeof(page_data));
-            free_table(ctx, it);
-            if (it == iter->tables)
-              iter->tables = n;
-          }
-          it = n;
-        }
-      }
+      sweep_tables(ctx, iter);
       /* window itself is not used anymore so free */
       if (iter->seq != ctx->seq || iter->flags & static_cast<decltype(iter->flags)>(window_flags::WINDOW_CLOSED)) {
         window* next = iter->next;
@@ -243,6 +277,156 @@ namespace nk {
     command* parent_last = ptr_add(command, memory, buf->parent);
     parent_last->next = buf->end;
   }
+  INTERN hash
+  command_range_hash(const context* ctx, std::size_t begin, const std::size_t last, hash seed) {
+    /* hashes command payloads only so the result does not depend on where the
+     * commands are placed inside the command memory */
+    const std::uint8_t* buffer = (const std::uint8_t*) ctx->memory.memory.ptr;
+    while (1) {
+      const command* cmd = ptr_add_const(command, buffer, begin);
+      const std::size_t end = cmd->next;
+      seed = murmur_hash(&cmd->type, (int) sizeof(cmd->type), seed);
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+      seed = murmur_hash(&cmd->userdata, (int) sizeof(cmd->userdata), seed);
+#endif
+      if (end > begin + sizeof(command))
+        seed = murmur_hash(cmd + 1, (int) (end - begin - sizeof(command)), seed);
+      if (begin == last || cmd->next <= begin)
+        break;
+      begin = cmd->next;
+    }
+    return seed;
+  }
+  INTERN bool
+  cull_is_hidden(const rectf* occluders, const int count, const rectf r) {
+    for (int i = 0; i < count; ++i) {
+      const rectf* o = &occluders[i];
+      if (r.x >= o->x && r.y >= o->y && r.x + r.w <= o->x + o->w && r.y + r.h <= o->y + o->h)
+        return true;
+    }
+    return false;
+  }
+  INTERN rectf
+  cull_window_occluder(const context* ctx, const window* win) {
+    /* largest opaque area of the window made of unrounded filled rectangles,
+     * usually its header and background */
+    const std::uint8_t* buffer = (const std::uint8_t*) ctx->memory.memory.ptr;
+    rectf clip = null_rect;
+    rectf best = rect(0, 0, 0, 0);
+    std::size_t offset = win->buffer.begin;
+    while (1) {
+      const command* cmd = ptr_add_const(command, buffer, offset);
+      if (cmd->type == command_type::COMMAND_SCISSOR) {
+        const command_scissor* s = (const command_scissor*) cmd;
+        clip = rect(s->x, s->y, s->w, s->h);
+      } else if (cmd->type == command_type::COMMAND_RECT_FILLED) {
+        const command_rect_filled* f = (const command_rect_filled*) cmd;
+        if (f->color.a == 255 && !f->rounding) {
+          const float x0 = std::max((float) f->x, clip.x), y0 = std::max((float) f->y, clip.y);
+          const float x1 = std::min((float) f->x + f->w, clip.x + clip.w);
+          const float y1 = std::min((float) f->y + f->h, clip.y + clip.h);
+          const rectf r = rect(x0, y0, x1 - x0, y1 - y0);
+          if (r.w > 0 && r.h > 0) {
+            if (r.x == best.x && r.w == best.w && r.y <= best.y + best.h && best.y <= r.y + r.h) {
+              /* stack vertically touching rectangles like header and body */
+              const float top = std::min(r.y, best.y);
+              best.h = std::max(r.y + r.h, best.y + best.h) - top;
+              best.y = top;
+            } else if (r.y == best.y && r.h == best.h && r.x <= best.x + best.w && best.x <= r.x + r.w) {
+              const float left = std::min(r.x, best.x);
+              best.w = std::max(r.x + r.w, best.x + best.w) - left;
+              best.x = left;
+            } else if (r.w * r.h > best.w * best.h) {
+              best = r;
+            }
+          }
+        }
+      }
+      if (offset == win->buffer.last || cmd->next <= offset || cmd->next >= ctx->memory.allocated)
+        break;
+      offset = cmd->next;
+    }
+    return best;
+  }
+  INTERN void
+  cull_occluded(context* ctx) {
+    std::uint8_t* buffer = (std::uint8_t*) ctx->memory.memory.ptr;
+    rectf occluders[NK_OCCLUSION_MAX_OCCLUDERS];
+    int count = 0;
+
+    ctx->culled_commands = 0;
+    ctx->culled_windows = 0;
+    /* convert scales every alpha by the global alpha, so nothing stays opaque below one */
+    if (ctx->occlusion_alpha < 1.0f)
+      return;
+    /* walk front to back so every window is tested against all windows above it */
+    for (window* it = ctx->end; it; it = it->prev) {
+      if (it->buffer.last == it->buffer.begin || (it->flags & static_cast<decltype(it->flags)>(window_flags::WINDOW_HIDDEN)) ||
+          it->seq != ctx->seq)
+        continue;
+
+      /* borders are stroked centered on the window bounds */
+      if (count && cull_is_hidden(occluders, count, shrirect(it->bounds, -(ctx->style.window.border + 1.0f)))) {
+        /* window is skipped by `build` and the command iterators */
+        it->buffer.begin = it->buffer.end;
+        it->buffer.last = it->buffer.end;
+        ctx->culled_windows++;
+        continue;
+      }
+      if (count) {
+        std::size_t offset = it->buffer.begin;
+        while (1) {
+          command* cmd = ptr_add(command, buffer, offset);
+          rectf bounds;
+          if (command_bounds(cmd, &bounds) && cull_is_hidden(occluders, count, bounds)) {
+            /* keeps the command chain and changes the window command hash */
+            cmd->type = command_type::COMMAND_NOP;
+            ctx->culled_commands++;
+          }
+          if (offset == it->buffer.last || cmd->next <= offset || cmd->next >= ctx->memory.allocated)
+            break;
+          offset = cmd->next;
+        }
+      }
+      const rectf occluder = cull_window_occluder(ctx, it);
+      if (occluder.w <= 0 || occluder.h <= 0)
+        continue;
+      if (count < NK_OCCLUSION_MAX_OCCLUDERS) {
+        occluders[count++] = occluder;
+      } else {
+        /* replace the smallest occluder if the new one covers more */
+        int smallest = 0;
+        for (int i = 1; i < count; ++i) {
+          if (occluders[i].w * occluders[i].h < occluders[smallest].w * occluders[smallest].h)
+            smallest = i;
+        }
+        if (occluder.w * occluder.h > occluders[smallest].w * occluders[smallest].h)
+          occluders[smallest] = occluder;
+      }
+    }
+  }
+  INTERN void
+  build_hashes(context* ctx) {
+    hash frame = 0;
+    window* it = ctx->begin;
+    while (it != 0) {
+      hash h = 0;
+      if (it->buffer.last != it->buffer.begin && !(it->flags & static_cast<decltype(it->flags)>(window_flags::WINDOW_HIDDEN)) &&
+          it->seq == ctx->seq) {
+        h = command_range_hash(ctx, it->buffer.begin, it->buffer.last, it->name);
+        if (it->popup.buf.active)
+          h = command_range_hash(ctx, it->popup.buf.begin, it->popup.buf.last, h);
+      }
+      it->command_modified = (h != it->command_hash);
+      it->command_hash = h;
+      frame = murmur_hash(&h, (int) sizeof(h), frame);
+      it = it->next;
+    }
+    if (ctx->overlay.end != ctx->overlay.begin)
+      frame = command_range_hash(ctx, ctx->overlay.begin, ctx->overlay.last, frame);
+    ctx->frame_modified = (frame != ctx->frame_hash);
+    ctx->frame_hash = frame;
+  }
   NK_LIB void
   build(context* ctx) {
     window* it = 0;
@@ -266,6 +450,12 @@ namespace nk {
       draw_image(&ctx->overlay, mouse_bounds, &cursor->img, white);
       finish_buffer(ctx, &ctx->overlay);
     }
+    /* drop what is hidden before fingerprinting so cached output matches */
+    if (ctx->occlusion_culling)
+      cull_occluded(ctx);
+    /* fingerprint command streams before they get linked together */
+    build_hashes(ctx);
+
     /* build one big draw command list out of all window buffers */
     it = ctx->begin;
     buffer = (std::uint8_t*) ctx->memory.memory.ptr;
@@ -290,6 +480,7 @@ namespace nk {
     while (it != 0) {
       window* next = it->next;
       popup_buffer* buf;
+      it->popup.buf.linked = it->popup.buf.active;
       if (!it->popup.buf.active)
         goto skip;
 
@@ -330,6 +521,25 @@ namespace nk {
     return ptr_add_const(command, buffer, iter->buffer.begin);
   }
 
+  NK_API void
+  set_occlusion_culling(context* ctx, const bool enable, const float global_alpha) {
+    NK_ASSERT(ctx);
+    if (!ctx)
+      return;
+    ctx->occlusion_culling = enable;
+    ctx->occlusion_alpha = global_alpha;
+  }
+  NK_API bool
+  frame_changed(context* ctx) {
+    NK_ASSERT(ctx);
+    if (!ctx)
+      return true;
+    if (!ctx->build) {
+      build(ctx);
+      ctx->build = true;
+    }
+    return ctx->frame_modified;
+  }
   NK_API const command*
   _next(context* ctx, const command* cmd) {
     NK_ASSERT(ctx);
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <nk/nuklear.hpp>
+
+namespace nk {
+  /* ===============================================================
+   *
+   *                              DAMAGE
+   *
+   * ===============================================================*/
+  NK_API void
+  damage_tracker_init(struct damage_tracker* tracker, const struct allocator* alloc) {
+    NK_ASSERT(tracker);
+    NK_ASSERT(alloc);
+    if (!tracker || !alloc)
+      return;
+    zero_struct(*tracker);
+    buffer_init(&tracker->entries[0], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    buffer_init(&tracker->entries[1], alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    buffer_init(&tracker->rects, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  }
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+  NK_API void
+  damage_tracker_init_default(struct damage_tracker* tracker) {
+    struct allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = malloc;
+    alloc.free = mfree;
+    damage_tracker_init(tracker, &alloc);
+  }
+#endif
+  NK_API void
+  damage_tracker_clear(struct damage_tracker* tracker) {
+    NK_ASSERT(tracker);
+    if (!tracker)
+      return;
+    tracker->valid = false;
+  }
+  NK_API void
+  damage_tracker_free(struct damage_tracker* tracker) {
+    NK_ASSERT(tracker);
+    if (!tracker)
+      return;
+    buffer_free(&tracker->entries[0]);
+    buffer_free(&tracker->entries[1]);
+    buffer_free(&tracker->rects);
+    zero_struct(*tracker);
+  }
+  INTERN bool
+  damage_record_range(const context* ctx, memory_buffer* out, unsigned int* count,
+                      std::size_t offset, const std::size_t last, const hash layer, rectf* clip) {
+    /* records commands from `offset` up to and including `last` or the end of the chain */
+    const std::uint8_t* buffer = (const std::uint8_t*) ctx->memory.memory.ptr;
+    while (1) {
+      const command* cmd = ptr_add_const(command, buffer, offset);
+      rectf bounds;
+      if (cmd->type == command_type::COMMAND_SCISSOR) {
+        const command_scissor* s = (const command_scissor*) cmd;
+        *clip = rect(s->x, s->y, s->w, s->h);
+      } else if (cmd->type != command_type::COMMAND_NOP) {
+        /* custom commands can draw anywhere inside the scissor rectangle */
+        if (!command_bounds(cmd, &bounds))
+          bounds = *clip;
+        const float x0 = std::max(bounds.x, clip->x), y0 = std::max(bounds.y, clip->y);
+        const float x1 = std::min(bounds.x + bounds.w, clip->x + clip->w);
+        const float y1 = std::min(bounds.y + bounds.h, clip->y + clip->h);
+        if (x1 > x0 && y1 > y0) {
+          struct damage_entry* e = (struct damage_entry*) buffer_alloc(out, buffer_allocation_type::BUFFER_FRONT,
+                                                                     sizeof(*e), alignof(struct damage_entry));
+          if (!e)
+            return false;
+          e->bounds = rect(x0, y0, x1 - x0, y1 - y0);
+          e->key = murmur_hash(clip, (int) sizeof(*clip), layer);
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+          e->key = murmur_hash(&cmd->userdata, (int) sizeof(cmd->userdata), e->key);
+#endif
+          e->key = murmur_hash(&cmd->type, (int) sizeof(cmd->type), e->key);
+          e->key = murmur_hash(cmd + 1, (int) (command_size(cmd) - sizeof(command)), e->key);
+          (*count)++;
+        }
+      }
+      if (offset == last || cmd->next <= offset || cmd->next >= ctx->memory.allocated)
+        break;
+      offset = cmd->next;
+    }
+    return true;
+  }
+  INTERN bool
+  damage_record(context* ctx, memory_buffer* out, unsigned int* count) {
+    rectf clip = null_rect;
+    unsigned int layer = 0;
+
+    /* the stacking order is part of the key so raising a window damages it */
+    for (const window* it = ctx->begin; it; it = it->next) {
+      if (it->buffer.last == it->buffer.begin || (it->flags & static_cast<decltype(it->flags)>(window_flags::WINDOW_HIDDEN)) ||
+          it->seq != ctx->seq)
+        continue;
+      const hash seed = murmur_hash(&layer, (int) sizeof(layer), it->name);
+      if (!damage_record_range(ctx, out, count, it->buffer.begin, it->buffer.last, seed, &clip))
+        return false;
+      layer++;
+    }
+    /* popups and the overlay are linked behind the last window in window order,
+     * their memory may lie before their predecessor so each range is recorded on its own */
+    for (const window* it = ctx->begin; it; it = it->next) {
+      if (!it->popup.buf.linked)
+        continue;
+      const hash seed = murmur_hash(&layer, (int) sizeof(layer), it->name);
+      if (!damage_record_range(ctx, out, count, it->popup.buf.begin, it->popup.buf.last, seed, &clip))
+        return false;
+      layer++;
+    }
+    if (ctx->overlay.end != ctx->overlay.begin)
+      return damage_record_range(ctx, out, count, ctx->overlay.begin, ctx->overlay.last, layer, &clip);
+    return true;
+  }
+  INTERN bool
+  damage_touches(const rectf a, const rectf b) {
+    return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+  }
+  INTERN rectf
+  damage_union(const rectf a, const rectf b) {
+    const float x0 = std::min(a.x, b.x), y0 = std::min(a.y, b.y);
+    const float x1 = std::max(a.x + a.w, b.x + b.w), y1 = std::max(a.y + a.h, b.y + b.h);
+    return rect(x0, y0, x1 - x0, y1 - y0);
+  }
+  INTERN int
+  damage_merge(rectf* rects, int count, const int max) {
+    /* too many rectangles to merge pairwise, the bounding box is cheaper to compute and to redraw */
+    if (count > NK_DAMAGE_MERGE_LIMIT) {
+      for (int i = 1; i < count; ++i)
+        rects[0] = damage_union(rects[0], rects[i]);
+      return 1;
+    }
+    /* merge touching rectangles first since that never adds clean area */
+    bool merged = true;
+    while (merged) {
+      merged = false;
+      for (int i = 0; i < count; ++i) {
+        for (int j = i + 1; j < count; ++j) {
+          if (!damage_touches(rects[i], rects[j]))
+            continue;
+          rects[i] = damage_union(rects[i], rects[j]);
+          rects[j--] = rects[--count];
+          merged = true;
+        }
+      }
+    }
+    while (count > max) {
+      /* merge the pair that adds the least clean area */
+      int best_i = 0, best_j = 1;
+      float best = -1;
+      for (int i = 0; i < count; ++i) {
+        for (int j = i + 1; j < count; ++j) {
+          const rectf u = damage_union(rects[i], rects[j]);
+          const float cost = u.w * u.h - rects[i].w * rects[i].h - rects[j].w * rects[j].h;
+          if (best < 0 || cost < best) {
+            best = cost;
+            best_i = i;
+            best_j = j;
+          }
+        }
+      }
+      rects[best_i] = damage_union(rects[best_i], rects[best_j]);
+      rects[best_j] = rects[--count];
+    }
+    return count;
+  }
+  NK_API int
+  frame_damage(context* ctx, struct damage_tracker* tracker, rectf* rects, const int max) {
+    NK_ASSERT(ctx);
+    NK_ASSERT(tracker);
+    NK_ASSERT(rects);
+    NK_ASSERT(max > 0);
+    if (!ctx || !tracker || !rects || max <= 0)
+      return -1;
+    if (!ctx->build) {
+      build(ctx);
+      ctx->build = true;
+    }
+
+    const unsigned int next = !tracker->current;
+    memory_buffer* out = &tracker->entries[next];
+    buffer_clear(out);
+    tracker->counts[next] = 0;
+    if (ctx->count && !damage_record(ctx, out, &tracker->counts[next])) {
+      tracker->valid = false;
+      return -1;
+    }
+    struct damage_entry* cur = (struct damage_entry*) buffer_memory(out);
+    std::sort(cur, cur + tracker->counts[next], [](const struct damage_entry& a, const struct damage_entry& b) { return a.key < b.key; });
+
+    const bool valid = tracker->valid;
+    const struct damage_entry* prev = (const struct damage_entry*) buffer_memory_const(&tracker->entries[tracker->current]);
+    const unsigned int prev_count = tracker->counts[tracker->current];
+    tracker->current = next;
+    tracker->valid = true;
+    if (!valid)
+      return -1;
+
+    /* commands found in only one of both frames are dirty in both places */
+    buffer_clear(&tracker->rects);
+    int count = 0;
+    unsigned int i = 0, j = 0;
+    while (i < prev_count || j < tracker->counts[next]) {
+      const struct damage_entry* dirty;
+      if (j == tracker->counts[next] || (i < prev_count && prev[i].key < cur[j].key)) {
+        dirty = &prev[i++];
+      } else if (i == prev_count || cur[j].key < prev[i].key) {
+        dirty = &cur[j++];
+      } else {
+        i++;
+        j++;
+        continue;
+      }
+      rectf* r = (rectf*) buffer_alloc(&tracker->rects, buffer_allocation_type::BUFFER_FRONT, sizeof(rectf), alignof(rectf));
+      if (!r)
+        return -1;
+      *r = dirty->bounds;
+      count++;
+    }
+    if (!count)
+      return 0;
+    rectf* dirty = (rectf*) buffer_memory(&tracker->rects);
+    count = damage_merge(dirty, count, max);
+    std::copy(dirty, dirty + count, rects);
+    return count;
+  }
+}
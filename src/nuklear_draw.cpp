@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <cstring>
 #include <memory>
 #include <nk/nuklear.hpp>
@@ -64,6 +65,147 @@ namespace nk {
     b->end = cmd->next;
     return cmd;
   }
+  INTERN rectf
+  command_points_bounds(const vec2i* points, const int count, const float pad) {
+    float x0 = points[0].x, y0 = points[0].y, x1 = x0, y1 = y0;
+    for (int i = 1; i < count; ++i) {
+      x0 = std::min(x0, (float) points[i].x);
+      y0 = std::min(y0, (float) points[i].y);
+      x1 = std::max(x1, (float) points[i].x);
+      y1 = std::max(y1, (float) points[i].y);
+    }
+    return rect(x0 - pad, y0 - pad, (x1 - x0) + 2 * pad, (y1 - y0) + 2 * pad);
+  }
+  NK_LIB bool
+  command_bounds(const command* cmd, rectf* r) {
+    /* conservative bounds including line width and the anti-aliasing fringe */
+    switch (cmd->type) {
+      case command_type::COMMAND_LINE: {
+        const command_line* l = (const command_line*) cmd;
+        const vec2i points[2] = {l->begin, l->end};
+        *r = command_points_bounds(points, 2, l->line_thickness + 1.0f);
+      } break;
+      case command_type::COMMAND_CURVE: {
+        const command_curve* c = (const command_curve*) cmd;
+        const vec2i points[4] = {c->begin, c->ctrl[0], c->ctrl[1], c->end};
+        *r = command_points_bounds(points, 4, c->line_thickness + 1.0f);
+      } break;
+      case command_type::COMMAND_RECT: {
+        const command_rect* c = (const command_rect*) cmd;
+        *r = shrirect(rect(c->x, c->y, c->w, c->h), -(c->line_thickness + 1.0f));
+      } break;
+      case command_type::COMMAND_RECT_FILLED: {
+        const command_rect_filled* c = (const command_rect_filled*) cmd;
+        *r = shrirect(rect(c->x, c->y, c->w, c->h), -1.0f);
+      } break;
+      case command_type::COMMAND_RECT_MULTI_COLOR: {
+        const command_rect_multi_color* c = (const command_rect_multi_color*) cmd;
+        *r = shrirect(rect(c->x, c->y, c->w, c->h), -1.0f);
+      } break;
+      case command_type::COMMAND_CIRCLE: {
+        const command_circle* c = (const command_circle*) cmd;
+        *r = shrirect(rect(c->x, c->y, c->w, c->h), -(c->line_thickness + 1.0f));
+      } break;
+      case command_type::COMMAND_CIRCLE_FILLED: {
+        const command_circle_filled* c = (const command_circle_filled*) cmd;
+        *r = shrirect(rect(c->x, c->y, c->w, c->h), -1.0f);
+      } break;
+      case command_type::COMMAND_ARC: {
+        const command_arc* c = (const command_arc*) cmd;
+        const float pad = c->r + c->line_thickness + 1.0f;
+        *r = rect(c->cx - pad, c->cy - pad, 2 * pad, 2 * pad);
+      } break;
+      case command_type::COMMAND_ARC_FILLED: {
+        const command_arc_filled* c = (const command_arc_filled*) cmd;
+        const float pad = c->r + 1.0f;
+        *r = rect(c->cx - pad, c->cy - pad, 2 * pad, 2 * pad);
+      } break;
+      case command_type::COMMAND_TRIANGLE: {
+        const command_triangle* t = (const command_triangle*) cmd;
+        const vec2i points[3] = {t->a, t->b, t->c};
+        *r = command_points_bounds(points, 3, t->line_thickness + 1.0f);
+      } break;
+      case command_type::COMMAND_TRIANGLE_FILLED: {
+        const command_triangle_filled* t = (const command_triangle_filled*) cmd;
+        const vec2i points[3] = {t->a, t->b, t->c};
+        *r = command_points_bounds(points, 3, 1.0f);
+      } break;
+      case command_type::COMMAND_POLYGON: {
+        const command_polygon* p = (const command_polygon*) cmd;
+        if (!p->point_count)
+          return false;
+        *r = command_points_bounds(p->points, p->point_count, p->line_thickness + 1.0f);
+      } break;
+      case command_type::COMMAND_POLYGON_FILLED: {
+        const command_polygon_filled* p = (const command_polygon_filled*) cmd;
+        if (!p->point_count)
+          return false;
+        *r = command_points_bounds(p->points, p->point_count, 1.0f);
+      } break;
+      case command_type::COMMAND_POLYLINE: {
+        const command_polyline* p = (const command_polyline*) cmd;
+        if (!p->point_count)
+          return false;
+        *r = command_points_bounds(p->points, p->point_count, p->line_thickness + 1.0f);
+      } break;
+      case command_type::COMMAND_TEXT: {
+        const command_text* t = (const command_text*) cmd;
+        *r = shrirect(rect(t->x, t->y, t->w, t->h), -1.0f);
+      } break;
+      case command_type::COMMAND_IMAGE: {
+        const command_image* i = (const command_image*) cmd;
+        *r = shrirect(rect(i->x, i->y, i->w, i->h), -1.0f);
+      } break;
+      default:
+        /* scissors carry state and custom commands can draw anywhere */
+        return false;
+    }
+    return true;
+  }
+  NK_LIB std::size_t
+  command_size(const command* cmd) {
+    /* bytes used by a command without the alignment padding up to the next one */
+    switch (cmd->type) {
+      case command_type::COMMAND_SCISSOR:
+        return sizeof(command_scissor);
+      case command_type::COMMAND_LINE:
+        return sizeof(command_line);
+      case command_type::COMMAND_CURVE:
+        return sizeof(command_curve);
+      case command_type::COMMAND_RECT:
+        return sizeof(command_rect);
+      case command_type::COMMAND_RECT_FILLED:
+        return sizeof(command_rect_filled);
+      case command_type::COMMAND_RECT_MULTI_COLOR:
+        return sizeof(command_rect_multi_color);
+      case command_type::COMMAND_CIRCLE:
+        return sizeof(command_circle);
+      case command_type::COMMAND_CIRCLE_FILLED:
+        return sizeof(command_circle_filled);
+      case command_type::COMMAND_ARC:
+        return sizeof(command_arc);
+      case command_type::COMMAND_ARC_FILLED:
+        return sizeof(command_arc_filled);
+      case command_type::COMMAND_TRIANGLE:
+        return sizeof(command_triangle);
+      case command_type::COMMAND_TRIANGLE_FILLED:
+        return sizeof(command_triangle_filled);
+      case command_type::COMMAND_POLYGON:
+        return offsetof(command_polygon, points) + sizeof(vec2i) * ((const command_polygon*) cmd)->point_count;
+      case command_type::COMMAND_POLYGON_FILLED:
+        return offsetof(command_polygon_filled, points) + sizeof(vec2i) * ((const command_polygon_filled*) cmd)->point_count;
+      case command_type::COMMAND_POLYLINE:
+        return offsetof(command_polyline, points) + sizeof(vec2i) * ((const command_polyline*) cmd)->point_count;
+      case command_type::COMMAND_TEXT:
+        return offsetof(command_text, string) + (std::size_t) ((const command_text*) cmd)->length + 1;
+      case command_type::COMMAND_IMAGE:
+        return sizeof(command_image);
+      case command_type::COMMAND_CUSTOM:
+        return sizeof(command_custom);
+      default:
+        return sizeof(command);
+    }
+  }
   NK_API void
   push_scissor(command_buffer* b, const rectf r) {
     NK_ASSERT(b);
@@ -499,6 +499,15 @@ namespace nk {
     }
     return text_width;
   }
+  INTERN float
+  font_glyph_advance(resource_handle handle, float height, rune codepoint) {
+    struct font* font = (struct font*) handle.ptr;
+    NK_ASSERT(font);
+    NK_ASSERT(font->glyphs);
+    if (!font || codepoint == NK_UTF_INVALID)
+      return 0;
+    return font_find_glyph(font, codepoint)->xadvance * (height / font->info.height);
+  }
 #ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
   INTERN void
   font_query_font_glyph(resource_handle handle, float height,
@@ -540,6 +549,33 @@ namespace nk {
     if (!font || !font->glyphs)
       return 0;
 
+    if (font->lookup) {
+      const struct font_glyph_lookup* lookup = font->lookup;
+      if (unicode < 0x10000) {
+        const unsigned int page = lookup->directory[unicode >> NK_FONT_LOOKUP_PAGE_BITS];
+        if (page) {
+          const rune index = lookup->pages[((page - 1) * NK_FONT_LOOKUP_PAGE_SIZE) + (unicode & (NK_FONT_LOOKUP_PAGE_SIZE - 1))];
+          if (index)
+            return &font->glyphs[index - 1];
+        }
+        return font->fallback;
+      }
+      if (!lookup->overlapping) {
+        int lo = 0;
+        int hi = lookup->range_count;
+        while (lo < hi) {
+          const int mid = lo + (hi - lo) / 2;
+          if (lookup->ranges[mid].first <= unicode)
+            lo = mid + 1;
+          else
+            hi = mid;
+        }
+        if (lo > 0 && unicode <= lookup->ranges[lo - 1].last)
+          return &font->glyphs[lookup->ranges[lo - 1].glyph + (unicode - lookup->ranges[lo - 1].first)];
+        return font->fallback;
+      }
+    }
+
     glyph = font->fallback;
     iter = font->config;
     do {
@@ -556,6 +592,98 @@ namespace nk {
     return glyph;
   }
   INTERN void
+  font_free_lookup(struct font* font, const struct allocator* alloc) {
+    if (!font->lookup)
+      return;
+    alloc->free(alloc->userdata, font->lookup);
+    font->lookup = 0;
+  }
+  INTERN bool
+  font_build_lookup(struct font* font, const struct allocator* alloc) {
+    unsigned short directory[NK_FONT_LOOKUP_PAGE_COUNT] = {0};
+    unsigned int page_count = 0;
+    int supplementary_count = 0;
+    rune total_glyphs = 0;
+    const font_config* iter;
+    struct font_glyph_lookup* lookup;
+    std::size_t size;
+
+    NK_ASSERT(font);
+    NK_ASSERT(alloc);
+    if (!font || !font->glyphs || !font->config)
+      return false;
+    font_free_lookup(font, alloc);
+
+    /* find all basic multilingual plane pages and ranges above it */
+    iter = font->config;
+    do {
+      const int count = range_count(iter->range);
+      for (int i = 0; i < count; ++i) {
+        const rune f = iter->range[(i * 2) + 0];
+        const rune t = iter->range[(i * 2) + 1];
+        if (f < 0x10000) {
+          const rune last = std::min(t, (rune) 0xFFFF);
+          for (rune p = f >> NK_FONT_LOOKUP_PAGE_BITS; p <= (last >> NK_FONT_LOOKUP_PAGE_BITS); ++p) {
+            if (!directory[p])
+              directory[p] = (unsigned short) ++page_count;
+          }
+        }
+        if (t >= 0x10000)
+          supplementary_count++;
+      }
+    } while ((iter = iter->n) != font->config);
+
+    size = sizeof(struct font_glyph_lookup) +
+           sizeof(rune) * page_count * NK_FONT_LOOKUP_PAGE_SIZE +
+           sizeof(struct font_glyph_range) * (std::size_t) supplementary_count;
+    lookup = (struct font_glyph_lookup*) alloc->alloc(alloc->userdata, 0, size);
+    NK_ASSERT(lookup);
+    if (!lookup)
+      return false;
+    zero(lookup, size);
+    std::memcpy(lookup->directory, directory, sizeof(directory));
+    lookup->pages = (rune*) (void*) (lookup + 1);
+    lookup->ranges = (struct font_glyph_range*) (void*) (lookup->pages + page_count * NK_FONT_LOOKUP_PAGE_SIZE);
+
+    /* fill in glyph indices in range order so the first matching range wins
+     * just like in the linear search */
+    iter = font->config;
+    do {
+      const int count = range_count(iter->range);
+      for (int i = 0; i < count; ++i) {
+        const rune f = iter->range[(i * 2) + 0];
+        const rune t = iter->range[(i * 2) + 1];
+        for (rune u = f; u <= t && u < 0x10000; ++u) {
+          rune* entry = &lookup->pages[((directory[u >> NK_FONT_LOOKUP_PAGE_BITS] - 1u) * NK_FONT_LOOKUP_PAGE_SIZE) + (u & (NK_FONT_LOOKUP_PAGE_SIZE - 1))];
+          if (!*entry)
+            *entry = total_glyphs + (u - f) + 1;
+        }
+        if (t >= 0x10000) {
+          /* insertion sort by first codepoint */
+          struct font_glyph_range range;
+          int j = lookup->range_count++;
+          range.first = std::max(f, (rune) 0x10000);
+          range.last = t;
+          range.glyph = total_glyphs + (range.first - f);
+          while (j > 0 && lookup->ranges[j - 1].first > range.first) {
+            lookup->ranges[j] = lookup->ranges[j - 1];
+            j--;
+          }
+          lookup->ranges[j] = range;
+        }
+        total_glyphs += (t - f) + 1;
+      }
+    } while ((iter = iter->n) != font->config);
+
+    /* the binary search can only find the first matching range if no two ranges overlap */
+    for (int j = 1; j < lookup->range_count; ++j) {
+      if (lookup->ranges[j].first <= lookup->ranges[j - 1].last)
+        lookup->overlapping = true;
+    }
+    font->lookup = lookup;
+    return true;
+  }
+  INTERN void
   font_init(struct font* font, float pixel_height,
             rune fallback_codepoint, struct font_glyph* glyphs,
             const struct baked_font* baked_font, resource_handle atlas) {
@@ -577,6 +705,7 @@ namespace nk {
 
     font->handle.height = font->info.height * font->scale;
     font->handle.width = font_text_width;
+    font->handle.advance = font_glyph_advance;
     font->handle.userdata.ptr = font;
 #ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
     font->handle.query = font_query_font_glyph;
@@ -1176,6 +1305,8 @@ namespace nk {
     NK_ASSERT(compressed_data);
     if (!compressed_data)
       return 0;
+    atlas->temporary_peak = std::max(atlas->temporary_peak, (std::size_t) compressed_size);
+    atlas->temporary_calls++;
     decode_85((unsigned char*) compressed_data, (const unsigned char*) data_base85);
     font = font_atlas_add_compressed(atlas, compressed_data,
                                      (std::size_t) compressed_size, height, config);
@@ -1255,6 +1386,9 @@ namespace nk {
     if (!atlas->pixel)
       goto failed;
 
+    atlas->temporary_peak = std::max(atlas->temporary_peak, tmp_size + img_size);
+    atlas->temporary_calls += 2;
+
     /* bake glyphs and custom white pixel into image */
     font_bake(baker, atlas->pixel, *width, *height,
               atlas->glyphs, atlas->glyph_count, atlas->config, atlas->font_num);
@@ -1268,6 +1402,8 @@ namespace nk {
       NK_ASSERT(img_rgba);
       if (!img_rgba)
         goto failed;
+      atlas->temporary_peak = std::max(atlas->temporary_peak, tmp_size + img_size + (std::size_t) (*width * *height * 4));
+      atlas->temporary_calls++;
       font_bake_convert(img_rgba, *width, *height, atlas->pixel);
       atlas->temporary.free(atlas->temporary.userdata, atlas->pixel);
       atlas->pixel = img_rgba;
@@ -1279,6 +1415,7 @@ namespace nk {
     for (font_iter = atlas->fonts; font_iter; font_iter = font_iter->next) {
       font* font = font_iter;
       font_config* config = font->config;
+      font_free_lookup(font, &atlas->permanent);
       font_init(font, config->size, config->fallback_glyph, atlas->glyphs,
                 config->font, handle_ptr(0));
     }
@@ -1346,6 +1483,8 @@ namespace nk {
 #ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
       font_iter->handle.texture = texture;
 #endif
+      /* without an index glyphs are still found by the linear range search */
+      font_build_lookup(font_iter, &atlas->permanent);
     }
     for (auto i = 0uz; i < static_cast<std::size_t>(style_cursor::CURSOR_COUNT); ++i)
       atlas->cursors[i].img.handle = texture;
@@ -1382,6 +1521,34 @@ namespace nk {
     }
   }
   NK_API void
+  font_atlas_info(struct memory_usage* usage, const struct font_atlas* atlas) {
+    NK_ASSERT(usage);
+    NK_ASSERT(atlas);
+    if (!usage || !atlas)
+      return;
+    zero_struct(*usage);
+
+    /* permanent memory: glyphs, fonts, configs and font files */
+    usage->used = sizeof(struct font_glyph) * (std::size_t) atlas->glyph_count;
+    for (const font* iter = atlas->fonts; iter; iter = iter->next)
+      usage->used += sizeof(struct font);
+    for (const font_config* iter = atlas->config; iter; iter = iter->next) {
+      usage->used += sizeof(struct font_config);
+      if (iter->ttf_blob)
+        usage->used += iter->ttf_size;
+      for (const font_config* i = iter->n; i && i != iter; i = i->n) {
+        if (i->ttf_blob)
+          usage->used += i->ttf_size;
+      }
+    }
+    /* the baked image stays temporary memory until `font_atlas_end`, counted as rgba */
+    if (atlas->pixel)
+      usage->used += (std::size_t) (atlas->tex_width * atlas->tex_height * 4);
+    usage->capacity = usage->used;
+    usage->peak = atlas->temporary_peak;
+    usage->calls = atlas->temporary_calls;
+  }
+  NK_API void
   font_atlas_clear(struct font_atlas* atlas) {
     NK_ASSERT(atlas);
     NK_ASSERT(atlas->temporary.alloc);
@@ -1412,6 +1579,7 @@ namespace nk {
       struct font *iter, *next;
       for (iter = atlas->fonts; iter; iter = next) {
         next = iter->next;
+        font_free_lookup(iter, &atlas->permanent);
         atlas->permanent.free(atlas->permanent.userdata, iter);
       }
       atlas->fonts = 0;
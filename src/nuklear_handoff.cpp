@@ -0,0 +1,81 @@
+#include <cstring>
+#include <nk/nuklear.hpp>
+
+namespace nk {
+  /* ===============================================================
+   *
+   *                              HANDOFF
+   *
+   * ===============================================================*/
+  NK_API void
+  frame_handoff_init(struct frame_handoff* handoff, const struct allocator* alloc) {
+    NK_ASSERT(handoff);
+    NK_ASSERT(alloc);
+    if (!handoff || !alloc)
+      return;
+    for (std::size_t i = 0; i < NK_LEN(handoff->slots); ++i) {
+      zero_struct(handoff->slots[i]);
+      buffer_init(&handoff->slots[i].commands, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    }
+    handoff->back = 0;
+    handoff->middle.store(1, std::memory_order_relaxed);
+    handoff->front = 2;
+    handoff->frame = 0;
+    handoff->has_front = false;
+  }
+  NK_API void
+  frame_handoff_free(struct frame_handoff* handoff) {
+    NK_ASSERT(handoff);
+    if (!handoff)
+      return;
+    for (std::size_t i = 0; i < NK_LEN(handoff->slots); ++i)
+      buffer_free(&handoff->slots[i].commands);
+  }
+  NK_API bool
+  frame_publish(struct frame_handoff* handoff, context* ctx) {
+    NK_ASSERT(handoff);
+    NK_ASSERT(ctx);
+    if (!handoff || !ctx)
+      return false;
+
+    /* copy into the slot only the UI thread owns, compacting the chain */
+    struct frame_slot* slot = &handoff->slots[handoff->back];
+    command_buffer out;
+    const command* cmd;
+    buffer_clear(&slot->commands);
+    command_buffer_init(&out, &slot->commands, NK_CLIPPING_OFF);
+    slot->command_count = 0;
+    foreach (cmd, ctx) {
+      if (cmd->type == command_type::COMMAND_NOP)
+        continue;
+      const std::size_t size = command_size(cmd);
+      command* dst = (command*) command_buffer_push(&out, cmd->type, size);
+      if (!dst)
+        return false;
+      const std::size_t next = dst->next;
+      std::memcpy(dst, cmd, size);
+      dst->next = next;
+      slot->command_count++;
+    }
+    slot->frame = handoff->frame++;
+
+    /* the release makes the slot contents visible to the acquiring render thread */
+    const unsigned int prev = handoff->middle.exchange(handoff->back | NK_FRAME_SLOT_FRESH, std::memory_order_acq_rel);
+    handoff->back = prev & ~NK_FRAME_SLOT_FRESH;
+    return true;
+  }
+  NK_API const struct frame_slot*
+  frame_acquire(struct frame_handoff* handoff) {
+    NK_ASSERT(handoff);
+    if (!handoff)
+      return 0;
+    if (handoff->middle.load(std::memory_order_relaxed) & NK_FRAME_SLOT_FRESH) {
+      const unsigned int prev = handoff->middle.exchange(handoff->front, std::memory_order_acq_rel);
+      handoff->front = prev & ~NK_FRAME_SLOT_FRESH;
+      handoff->has_front = true;
+    }
+    if (!handoff->has_front)
+      return 0;
+    return &handoff->slots[handoff->front];
+  }
+}
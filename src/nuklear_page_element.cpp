@@ -6,59 +6,94 @@ namespace nk {
    *                          PAGE ELEMENT
    *
    * ===============================================================*/
-  NK_LIB page_element*
-  create_page_element(context* ctx) {
-    page_element* elem;
-    if (ctx->freelist) {
+  NK_LIB std::size_t
+  page_element_size(const page_type type) {
+    switch (type) {
+      case page_type::PAGE_WINDOW:
+        return sizeof(window);
+      case page_type::PAGE_PANEL:
+        return sizeof(panel);
+      case page_type::PAGE_TABLE:
+        return sizeof(table);
+      default:
+        NK_ASSERT(0 && "invalid page element type");
+        return 0;
+    }
+  }
+  NK_LIB std::size_t
+  page_element_align(const page_type type) {
+    switch (type) {
+      case page_type::PAGE_WINDOW:
+        return alignof(window);
+      case page_type::PAGE_PANEL:
+        return alignof(panel);
+      case page_type::PAGE_TABLE:
+        return alignof(table);
+      default:
+        NK_ASSERT(0 && "invalid page element type");
+        return 1;
+    }
+  }
+  INTERN std::size_t
+  page_element_back_align() {
+    /* all elements in the back of a fixed buffer share the largest alignment and are padded
+     * to it, so only the first one can have padding towards the unaligned buffer end */
+    return std::max({alignof(window), alignof(panel), alignof(table)});
+  }
+  INTERN std::size_t
+  page_element_back_size(const page_type type) {
+    const std::size_t align = page_element_back_align();
+    return (page_element_size(type) + (align - 1)) & ~(align - 1);
+  }
+  NK_LIB void*
+  create_page_element(context* ctx, const page_type type) {
+    slab* slab = &ctx->pool.slabs[static_cast<unsigned>(type)];
+    const std::size_t size = page_element_size(type);
+    void* elem;
+    if (slab->freelist) {
       /* unlink page element from free list */
-      elem = ctx->freelist;
-      ctx->freelist = elem->next;
+      elem = slab->freelist;
+      slab->freelist = slab->freelist->next;
     } else if (ctx->use_pool) {
       /* allocate page element from memory pool */
-      elem = pool_alloc(&ctx->pool);
+      elem = pool_alloc(&ctx->pool, type);
       NK_ASSERT(elem);
       if (!elem)
         return 0;
     } else {
       /* allocate new page element from back of fixed size memory buffer */
-      NK_STORAGE const std::size_t size = sizeof(struct page_element);
-      NK_STORAGE const std::size_t align = alignof(struct page_element);
-      elem = (page_element*) buffer_alloc(&ctx->memory, buffer_allocation_type::BUFFER_BACK, size, align);
+      elem = buffer_alloc(&ctx->memory, buffer_allocation_type::BUFFER_BACK,
+                          page_element_back_size(type), page_element_back_align());
       NK_ASSERT(elem);
       if (!elem)
         return 0;
     }
-    zero_struct(*elem);
-    elem->next = 0;
-    elem->prev = 0;
+    slab->count++;
+    slab->calls++;
+    slab->peak = std::max(slab->peak, slab->count);
+    zero(elem, size);
     return elem;
   }
   NK_LIB void
-  lipage_element_into_freelist(context* ctx,
-                               page_element* elem) {
-    /* link table into freelist */
-    if (!ctx->freelist) {
-      ctx->freelist = elem;
-    } else {
-      elem->next = ctx->freelist;
-      ctx->freelist = elem;
-    }
-  }
-  NK_LIB void
-  free_page_element(context* ctx, page_element* elem) {
-    /* we have a pool so just add to free list */
-    if (ctx->use_pool) {
-      lipage_element_into_freelist(ctx, elem);
-      return;
-    }
+  free_page_element(context* ctx, const page_type type, void* elem) {
+    slab* slab = &ctx->pool.slabs[static_cast<unsigned>(type)];
+    NK_ASSERT(slab->count);
+    slab->count--;
+
     /* if possible remove last element from back of fixed memory buffer */
-    {
-      const void* elem_end = (void*) (elem + 1);
-      const void* buffer_end = (std::uint8_t*) ctx->memory.memory.ptr + ctx->memory.size;
-      if (elem_end == buffer_end)
-        ctx->memory.size -= sizeof(page_element);
-      else
-        lipage_element_into_freelist(ctx, elem);
+    if (!ctx->use_pool) {
+      const void* buffer_back = (std::uint8_t*) ctx->memory.memory.ptr + ctx->memory.size;
+      if (elem == buffer_back) {
+        ctx->memory.size += page_element_back_size(type);
+        /* every other element is at least one alignment in size, so a smaller rest is the padding of the first */
+        if (ctx->memory.memory.size - ctx->memory.size < page_element_back_align())
+          ctx->memory.size = ctx->memory.memory.size;
+        return;
+      }
     }
+    /* otherwise link into the freelist of its type */
+    page_element* node = (page_element*) elem;
+    node->next = slab->freelist;
+    slab->freelist = node;
   }
 } // namespace nk
@@ -9,17 +9,11 @@ namespace nk {
    * ===============================================================*/
   NK_LIB void*
   create_panel(context* ctx) {
-    page_element* elem = create_page_element(ctx);
-    if (!elem)
-      return 0;
-    zero_struct(*elem);
-    return &elem->data.pan;
+    return (panel*) create_page_element(ctx, page_type::PAGE_PANEL);
   }
   NK_LIB void
   free_panel(context* ctx, panel* pan) {
-    page_data* pd = NK_CONTAINER_OF(pan, union page_data, pan);
-    page_element* pe = NK_CONTAINER_OF(pd, struct page_element, data);
-    free_page_element(ctx, pe);
+    free_page_element(ctx, page_type::PAGE_PANEL, pan);
   }
   NK_LIB bool
   panel_has_header(const flag flags, const char* title) {
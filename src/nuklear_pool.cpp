@@ -6,60 +6,180 @@ namespace nk {
    *                              POOL
    *
    * ===============================================================*/
+  INTERN unsigned int
+  pool_page_capacity(const page_type type) {
+    switch (type) {
+      case page_type::PAGE_WINDOW:
+        return NK_WINDOW_PAGE_CAPACITY;
+      case page_type::PAGE_PANEL:
+        return NK_PANEL_PAGE_CAPACITY;
+      case page_type::PAGE_TABLE:
+        return NK_TABLE_PAGE_CAPACITY;
+      default:
+        return 0;
+    }
+  }
+  INTERN std::uint8_t*
+  pool_page_elements(page* page, const page_type type) {
+    return (std::uint8_t*) NK_ALIGN_PTR(page + 1, page_element_align(type));
+  }
   NK_LIB void
-  pool_init(pool* pool, const allocator* alloc,
-            const unsigned int capacity) {
-    NK_ASSERT(capacity >= 1);
+  pool_init(pool* pool, const allocator* alloc) {
+    NK_STATIC_ASSERT(NK_WINDOW_PAGE_CAPACITY >= 1);
+    NK_STATIC_ASSERT(NK_PANEL_PAGE_CAPACITY >= 1);
+    NK_STATIC_ASSERT(NK_TABLE_PAGE_CAPACITY >= 1);
     zero(pool, sizeof(*pool));
     pool->alloc = *alloc;
-    pool->capacity = capacity;
     pool->type = allocation_type::BUFFER_DYNAMIC;
-    pool->pages = 0;
   }
   NK_LIB void
   pool_free(pool* pool) {
     if (!pool)
       return;
-    page* iter = pool->pages;
     if (pool->type == allocation_type::BUFFER_FIXED)
       return;
-    while (iter) {
-      page* next = iter->next;
-      pool->alloc.free(pool->alloc.userdata, iter);
-      iter = next;
+    for (slab& slab : pool->slabs) {
+      page* iter = slab.pages;
+      while (iter) {
+        page* next = iter->next;
+        pool->alloc.free(pool->alloc.userdata, iter);
+        iter = next;
+      }
     }
   }
   NK_LIB void
   pool_init_fixed(pool* pool, void* memory, const std::size_t size) {
     zero(pool, sizeof(*pool));
-    NK_ASSERT(size >= sizeof(page));
-    if (size < sizeof(page))
-      return;
-    /* first page_element is embedded in page, additional elements follow in adjacent space */
-    pool->capacity = (unsigned) (1 + (size - sizeof(page)) / sizeof(page_element));
-    pool->pages = (page*) memory;
+    NK_ASSERT(memory);
+    NK_ASSERT(size);
+    pool->memory = memory;
     pool->type = allocation_type::BUFFER_FIXED;
     pool->size = size;
   }
-  NK_LIB page_element*
-  pool_alloc(pool* pool) {
-    if (!pool->pages || pool->pages->size >= pool->capacity) {
+  NK_LIB void*
+  pool_alloc(pool* pool, const page_type type) {
+    slab* slab = &pool->slabs[static_cast<unsigned>(type)];
+    const std::size_t size = page_element_size(type);
+    const std::size_t align = page_element_align(type);
+    if (pool->type == allocation_type::BUFFER_FIXED) {
+      /* take the element from the remaining fixed memory */
+      std::uint8_t* memory = (std::uint8_t*) pool->memory;
+      std::uint8_t* elem = (std::uint8_t*) NK_ALIGN_PTR(memory + pool->allocated, align);
+      NK_ASSERT(elem + size <= memory + pool->size);
+      if (elem + size > memory + pool->size)
+        return 0;
+      pool->allocated = (std::size_t) (elem + size - memory);
+      return elem;
+    }
+
+    page* page = slab->pages;
+    const unsigned int capacity = pool_page_capacity(type);
+    if (!page || page->size >= capacity) {
       /* allocate new page */
-      if (pool->type == allocation_type::BUFFER_FIXED) {
-        NK_ASSERT(pool->pages);
-        if (!pool->pages)
-          return 0;
-        NK_ASSERT(pool->pages->size < pool->capacity);
+      const std::size_t total = sizeof(struct page) + align + capacity * size;
+      page = (struct page*) pool->alloc.alloc(pool->alloc.userdata, 0, total);
+      if (!page)
         return 0;
-      } else {
-        std::size_t size = sizeof(struct page);
-        size += (pool->capacity - 1) * sizeof(page_element);
-        page* page = (struct page*) pool->alloc.alloc(pool->alloc.userdata, 0, size);
-        page->next = pool->pages;
-        pool->pages = page;
-        page->size = 0;
+      page->next = slab->pages;
+      page->size = 0;
+      slab->pages = page;
+      slab->page_count++;
+      slab->grows++;
+    }
+    return pool_page_elements(page, type) + size * page->size++;
+  }
+  NK_LIB void
+  pool_usage(struct pool_usage* usage, const pool* pool, const page_type type) {
+    const slab* slab = &pool->slabs[static_cast<unsigned>(type)];
+    const std::size_t size = page_element_size(type);
+    zero_struct(*usage);
+    usage->pages = slab->page_count;
+    usage->elements = slab->count;
+    for (const page_element* it = slab->freelist; it; it = it->next)
+      usage->free_elements++;
+
+    usage->memory.used = size * slab->count;
+    usage->memory.peak = size * slab->peak;
+    usage->memory.calls = slab->calls;
+    usage->memory.grows = slab->grows;
+    if (pool->type == allocation_type::BUFFER_DYNAMIC)
+      usage->memory.capacity = (sizeof(struct page) + page_element_align(type) + size * pool_page_capacity(type)) * slab->page_count;
+    else
+      usage->memory.capacity = size * (slab->count + usage->free_elements);
+  }
+  template <typename T>
+  INTERN T*
+  pool_sort_by_address(T* list) {
+    /* merge sort on the links themselves, trimming needs no memory of its own */
+    if (!list || !list->next)
+      return list;
+    T* slow = list;
+    for (T* fast = list->next; fast && fast->next; fast = fast->next->next)
+      slow = slow->next;
+    T* right = pool_sort_by_address(slow->next);
+    slow->next = 0;
+    T* left = pool_sort_by_address(list);
+
+    T* head = 0;
+    T** tail = &head;
+    while (left && right) {
+      T** lowest = (NK_PTR_TO_UINT(left) < NK_PTR_TO_UINT(right)) ? &left : &right;
+      *tail = *lowest;
+      tail = &(*lowest)->next;
+      *lowest = (*lowest)->next;
+    }
+    *tail = left ? left : right;
+    return head;
+  }
+  NK_LIB void
+  pool_trim(pool* pool) {
+    if (pool->type == allocation_type::BUFFER_FIXED)
+      return;
+    for (unsigned int t = 0; t < pool->slabs.size(); ++t) {
+      const page_type type = static_cast<page_type>(t);
+      const std::size_t size = page_element_size(type);
+      slab* slab = &pool->slabs[t];
+
+      /* only the first page can have room left, it is moved back to the front afterwards */
+      page* fill = slab->pages;
+      page** fill_link = 0;
+
+      /* with both lists sorted by address the free elements of a page form one run of the freelist */
+      slab->pages = pool_sort_by_address(slab->pages);
+      slab->freelist = pool_sort_by_address(slab->freelist);
+      page** link = &slab->pages;
+      page_element** free_link = &slab->freelist;
+      while (*link) {
+        page* page = *link;
+        const std::uint8_t* begin = pool_page_elements(page, type);
+        const std::uint8_t* end = begin + size * page->size;
+        while (*free_link && (std::uint8_t*) *free_link < begin)
+          free_link = &(*free_link)->next;
+
+        page_element** run = free_link;
+        unsigned int unused = 0;
+        while (*free_link && (std::uint8_t*) *free_link < end) {
+          free_link = &(*free_link)->next;
+          unused++;
+        }
+        if (unused != page->size) {
+          if (page == fill)
+            fill_link = link;
+          link = &page->next;
+          continue;
+        }
+        /* no element of this page is in use so unlink its run and release it */
+        *run = *free_link;
+        free_link = run;
+        *link = page->next;
+        pool->alloc.free(pool->alloc.userdata, page);
+        slab->page_count--;
+      }
+      if (fill_link && fill_link != &slab->pages) {
+        *fill_link = fill->next;
+        fill->next = slab->pages;
+        slab->pages = fill;
       }
     }
-    return &pool->pages->win[pool->pages->size++];
   }
 } // namespace nk
@@ -8,17 +8,11 @@ namespace nk {
    * ===============================================================*/
   NK_LIB table*
   create_table(context* ctx) {
-    page_element* elem = create_page_element(ctx);
-    if (!elem)
-      return 0;
-    zero_struct(*elem);
-    return &elem->data.tbl;
+    return (table*) create_page_element(ctx, page_type::PAGE_TABLE);
   }
   NK_LIB void
   free_table(context* ctx, table* tbl) {
-    page_data* pd = NK_CONTAINER_OF(tbl, union page_data, tbl);
-    page_element* pe = NK_CONTAINER_OF(pd, struct page_element, data);
-    free_page_element(ctx, pe);
+    free_page_element(ctx, page_type::PAGE_TABLE, tbl);
   }
   NK_LIB void
   push_table(window* win, table* tbl) {
@@ -47,6 +41,72 @@ namespace nk {
       tbl->prev->next = tbl->next;
     tbl->next = 0;
     tbl->prev = 0;
+    NK_ASSERT(win->table_count);
+    win->table_count--;
+  }
+  INTERN void
+  value_index_put(value_index* index, table* tbl, const unsigned int i) {
+    const unsigned int mask = index->capacity - 1;
+    unsigned int slot = tbl->keys[i] & mask;
+    while (index->slots[slot].tbl)
+      slot = (slot + 1) & mask;
+    index->slots[slot].tbl = tbl;
+    index->slots[slot].key = tbl->keys[i];
+    index->slots[slot].index = i;
+    index->count++;
+  }
+  INTERN void
+  value_index_remove(value_index* index, const table* tbl, const unsigned int i) {
+    const unsigned int mask = index->capacity - 1;
+    unsigned int slot = tbl->keys[i] & mask;
+    while (index->slots[slot].tbl != tbl || index->slots[slot].index != i) {
+      if (!index->slots[slot].tbl)
+        return;
+      slot = (slot + 1) & mask;
+    }
+    /* backward shift deletion so lookups never have to skip tombstones */
+    unsigned int hole = slot;
+    slot = (slot + 1) & mask;
+    while (index->slots[slot].tbl) {
+      const unsigned int home = index->slots[slot].key & mask;
+      if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+        index->slots[hole] = index->slots[slot];
+        hole = slot;
+      }
+      slot = (slot + 1) & mask;
+    }
+    index->slots[hole].tbl = 0;
+    index->count--;
+  }
+  NK_LIB void
+  free_value_index(context* ctx, window* win) {
+    if (win->values.slots)
+      ctx->pool.alloc.free(ctx->pool.alloc.userdata, win->values.slots);
+    zero_struct(win->values);
+  }
+  INTERN bool
+  value_index_grow(context* ctx, window* win) {
+    /* only contexts with a dynamic pool have an allocator to grow with */
+    if (!ctx->use_pool || ctx->pool.type != allocation_type::BUFFER_DYNAMIC)
+      return false;
+
+    value_index* index = &win->values;
+    const unsigned int capacity = index->capacity ? index->capacity * 2 : NK_VALUE_INDEX_MIN_CAPACITY;
+    const std::size_t size = capacity * sizeof(value_slot);
+    value_slot* slots = (value_slot*) ctx->pool.alloc.alloc(ctx->pool.alloc.userdata, 0, size);
+    free_value_index(ctx, win);
+    if (!slots)
+      return false;
+
+    /* rebuild from table pages which stay the owner of all values */
+    zero(slots, size);
+    index->slots = slots;
+    index->capacity = capacity;
+    for (table* it = win->tables; it; it = it->next) {
+      for (unsigned int i = 0; i < it->size; ++i)
+        value_index_put(index, it, i);
+    }
+    return true;
   }
   NK_LIB unsigned int*
   add_value(context* ctx, window* win,
@@ -62,13 +122,37 @@ namespace nk {
         return 0;
       push_table(win, tbl);
     }
-    win->tables->seq = win->seq;
-    win->tables->keys[win->tables->size] = name;
-    win->tables->values[win->tables->size] = value;
-    return &win->tables->values[win->tables->size++];
+    table* tbl = win->tables;
+    const unsigned int i = tbl->size++;
+    tbl->seq = win->seq;
+    tbl->keys[i] = name;
+    tbl->values[i] = value;
+
+    /* values never move so pointers stay valid, only the index is rebuilt */
+    value_index* index = &win->values;
+    if (index->slots && (index->count + 1) * 4 <= index->capacity * 3)
+      value_index_put(index, tbl, i);
+    else if (index->slots || tbl->next)
+      value_index_grow(ctx, win);
+    return &tbl->values[i];
   }
   NK_LIB unsigned int*
   find_value(const window* win, const hash name) {
+    const value_index* index = &win->values;
+    if (index->slots) {
+      const unsigned int mask = index->capacity - 1;
+      unsigned int slot = name & mask;
+      while (index->slots[slot].tbl) {
+        if (index->slots[slot].key == name) {
+          table* tbl = index->slots[slot].tbl;
+          tbl->seq = win->seq;
+          return &tbl->values[index->slots[slot].index];
+        }
+        slot = (slot + 1) & mask;
+      }
+      return 0;
+    }
+
     table* iter = win->tables;
     while (iter) {
       unsigned int i = 0;
@@ -84,4 +168,24 @@ namespace nk {
     }
     return 0;
   }
+  NK_LIB void
+  sweep_tables(context* ctx, window* win) {
+    /* only a few pages are checked each frame, the rest on the next calls */
+    table* it = win->table_sweep ? win->table_sweep : win->tables;
+    unsigned int budget = NK_TABLE_SWEEP_BUDGET;
+    while (it && budget--) {
+      table* n = it->next;
+      if (it->seq != ctx->seq) {
+        if (win->values.slots) {
+          for (unsigned int i = 0; i < it->size; ++i)
+            value_index_remove(&win->values, it, i);
+        }
+        remove_table(win, it);
+        zero(it, sizeof(*it));
+        free_table(ctx, it);
+      }
+      it = n;
+    }
+    win->table_sweep = it;
+  }
 } // namespace nk
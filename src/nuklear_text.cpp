@@ -23,10 +23,14 @@ namespace nk {
     label.y = b.y + t->padding.y;
     label.h = std::min(f->height, b.h - 2 * t->padding.y);
 
-    float text_width = f->width(f->userdata, f->height, (const char*) string, len);
-    text_width += (2.0f * t->padding.x);
+    /* align in x-axis: left aligned text is clamped by `draw_text` so only
+     * centered and right aligned text needs to be measured up front */
+    float text_width = 0;
+    if (!(a & NK_TEXT_ALIGN_LEFT)) {
+      text_width = f->width(f->userdata, f->height, (const char*) string, len);
+      text_width += (2.0f * t->padding.x);
+    }
 
-    /* align in x-axis */
     if (a & NK_TEXT_ALIGN_LEFT) {
       label.x = b.x + t->padding.x;
       label.w = std::max(0.0f, b.w - 2.0f * t->padding.x);
@@ -923,6 +923,15 @@ namespace nk {
     return buf;
   }
 #endif
+  NK_LIB float
+  text_glyph_width(const user_font* font, const char* glyph,
+                   const int glyph_len, const rune unicode) {
+    if (!glyph_len)
+      return 0;
+    if (font->advance)
+      return font->advance(font->userdata, font->height, unicode);
+    return font->width(font->userdata, font->height, glyph, glyph_len);
+  }
   NK_LIB int
   text_clamp(const user_font* font, const char* text,
              const int text_len, float space, int* glyphs, float* text_width,
@@ -940,10 +949,12 @@ namespace nk {
     float sep_width = 0;
     sep_count = std::max(sep_count, 0);
 
+    /* width is accumulated glyph by glyph instead of re-measuring the
+     * growing prefix, which keeps clamping linear in the text length */
     glyph_len = utf_decode(text, &unicode, text_len);
     while (glyph_len && (width < space) && (len < text_len)) {
+      float s = width + text_glyph_width(font, &text[len], glyph_len, unicode);
       len += glyph_len;
-      float s = font->width(font->userdata, font->height, text, len);
       for (i = 0; i < sep_count; ++i) {
         if (unicode != sep_list[i])
           continue;
@@ -987,7 +998,7 @@ namespace nk {
     glyph_len = utf_decode(begin, &unicode, byte_len);
     if (!glyph_len)
       return text_size;
-    float glyph_width = font->width(font->userdata, font->height, begin, glyph_len);
+    float glyph_width = text_glyph_width(font, begin, glyph_len, unicode);
 
     *glyphs = 0;
     while ((text_len < byte_len) && glyph_len) {
@@ -1015,7 +1026,7 @@ namespace nk {
       text_len += glyph_len;
       line_width += (float) glyph_width;
       glyph_len = utf_decode(begin + text_len, &unicode, byte_len - text_len);
-      glyph_width = font->width(font->userdata, font->height, begin + text_len, glyph_len);
+      glyph_width = text_glyph_width(font, begin + text_len, glyph_len, unicode);
       continue;
     }
 
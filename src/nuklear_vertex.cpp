@@ -1,8 +1,17 @@
 #include <algorithm>
 #include <cmath>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
 #include <nk/nuklear.hpp>
 
+#if !defined(NK_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NK_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace nk {
   /* ===============================================================
    *
@@ -26,6 +35,9 @@ namespace nk {
   }
 #endif
 #ifdef NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+  INTERN void draw_list_select_writer(struct draw_list* list);
+  INTERN flag convert_writers(struct context*, memory_buffer* cmds, memory_buffer* vertices, memory_buffer* elements,
+                              const struct convert_config*, draw_vertex_writer, draw_vertex_block_writer);
   NK_API void
   draw_list_init(struct draw_list* list) {
     std::size_t i = 0;
@@ -58,13 +70,17 @@ namespace nk {
     canvas->line_AA = line_aa;
     canvas->shape_AA = shape_aa;
     canvas->clip_rect = null_rect;
+    draw_list_select_writer(canvas);
 
     canvas->cmd_offset = 0;
     canvas->element_count = 0;
     canvas->vertex_count = 0;
+    canvas->vertex_base = 0;
     canvas->cmd_offset = 0;
     canvas->cmd_count = 0;
     canvas->path_count = 0;
+    canvas->instances = 0;
+    canvas->instance_count = 0;
   }
   NK_API const struct draw_command*
   _draw_list_begin(const struct draw_list* canvas, const memory_buffer* buffer) {
@@ -130,6 +146,7 @@ namespace nk {
       list->path_offset = (unsigned int) ((std::byte*) points - (std::byte*) memory);
     }
     list->path_count += (unsigned int) count;
+    list->path_peak = std::max(list->path_peak, list->path_count);
     return points;
   }
   INTERN vec2f
@@ -165,6 +182,8 @@ namespace nk {
     cmd->elem_count = 0;
     cmd->clip_rect = clip;
     cmd->texture = texture;
+    cmd->vertex_offset = list->vertex_base;
+    cmd->instance_count = 0;
 #ifdef NK_INCLUDE_COMMAND_USERDATA
     cmd->userdata = list->userdata;
 #endif
@@ -194,7 +213,7 @@ namespace nk {
       draw_list_push_command(list, rect, list->config.tex_null.texture);
     } else {
       struct draw_command* prev = draw_list_command_last(list);
-      if (prev->elem_count == 0)
+      if (prev->elem_count == 0 && !prev->instance_count)
         prev->clip_rect = rect;
       draw_list_push_command(list, rect, prev->texture);
     }
@@ -208,12 +227,12 @@ namespace nk {
       draw_list_push_command(list, null_rect, texture);
     } else {
       struct draw_command* prev = draw_list_command_last(list);
-      if (prev->elem_count == 0) {
+      if (prev->elem_count == 0 && !prev->instance_count) {
         prev->texture = texture;
 #ifdef NK_INCLUDE_COMMAND_USERDATA
         prev->userdata = list->userdata;
 #endif
-      } else if (prev->texture.id != texture.id
+      } else if (prev->instance_count || prev->texture.id != texture.id
 #ifdef NK_INCLUDE_COMMAND_USERDATA
                  || prev->userdata.id != list->userdata.id
 #endif
@@ -239,21 +258,54 @@ namespace nk {
     if (!vtx)
       return 0;
     list->vertex_count += (unsigned int) count;
-
-    /* This assert triggers because your are drawing a lot of stuff and nuklear
-     * defined `draw_index` as `unsigned short` to safe space be default.
-     *
-     * So you reached the maximum number of indices or rather vertexes.
-     * To solve this issue please change typedef `draw_index` to `std::uint32_t`
-     * and don't forget to specify the new element size in your drawing
-     * backend (OpenGL, DirectX, ...). For example in OpenGL for `glDrawElements`
-     * instead of specifying `GL_UNSIGNED_SHORT` you have to define `GL_UNSIGNED_INT`.
-     * Sorry for the inconvenience. */
-    if (sizeof(draw_index) == 2)
-      NK_ASSERT((list->vertex_count < NK_USHORT_MAX &&
-                 "To many vertices for 16-bit vertex indices. Please read comment above on how to solve this problem"));
     return vtx;
   }
+  INTERN bool
+  draw_list_needs_rebase(const struct draw_list* list, const unsigned int count) {
+    /* whether `count` more vertices can not be addressed from the current base vertex */
+    return sizeof(draw_index) == 2 && list->vertex_count + count - list->vertex_base > NK_USHORT_MAX;
+  }
+  INTERN std::size_t
+  draw_list_vertex_index(struct draw_list* list, std::size_t count) {
+    /* Returns the element value of the next vertex. If `count` more vertices
+     * would not be addressable by 16-bit indices a new draw command based at
+     * the next vertex is started, so `draw_index` can stay `unsigned short`. */
+    if (draw_list_needs_rebase(list, (unsigned int) count)) {
+      /* This assert triggers if a single shape needs more vertices than 16-bit
+       * indices can address. To solve this change typedef `draw_index` to
+       * `std::uint32_t` and specify the new element size in your backend. */
+      NK_ASSERT((count <= NK_USHORT_MAX && "To many vertices in one shape for 16-bit vertex indices"));
+      if (list->cmd_count) {
+        struct draw_command* prev = draw_list_command_last(list);
+        if (prev->elem_count) {
+          const rectf clip = prev->clip_rect;
+          const resource_handle texture = prev->texture;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+          const resource_handle userdata = prev->userdata;
+#endif
+          prev = draw_list_push_command(list, clip, texture);
+          if (!prev)
+            return list->vertex_count - list->vertex_base;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+          prev->userdata = userdata;
+#endif
+        }
+        prev->vertex_offset = list->vertex_count;
+      }
+      list->vertex_base = list->vertex_count;
+    }
+    return list->vertex_count - list->vertex_base;
+  }
+  INTERN void
+  draw_list_copy_elements(draw_index* dst, const draw_index* src,
+                          const unsigned int count, const unsigned int delta) {
+    if (!delta) {
+      std::memcpy(dst, src, sizeof(draw_index) * count);
+      return;
+    }
+    for (unsigned int i = 0; i < count; ++i)
+      dst[i] = (draw_index) (src[i] + delta);
+  }
   INTERN draw_index*
   draw_list_alloc_elements(struct draw_list* list, std::size_t count) {
     draw_index* ids;
@@ -269,10 +321,54 @@ namespace nk {
     if (!ids)
       return 0;
     cmd = draw_list_command_last(list);
+    if (cmd->instance_count) {
+      /* triangles after instances need their own draw command */
+      cmd = draw_list_push_command(list, cmd->clip_rect, cmd->texture);
+      if (!cmd)
+        return 0;
+    }
     list->element_count += (unsigned int) count;
     cmd->elem_count += (unsigned int) count;
     return ids;
   }
+  INTERN void
+  draw_list_add_instance(struct draw_list* list, resource_handle texture, rectf r,
+                         vec2f uva, vec2f uvc, float rounding, float thickness, struct color color) {
+    struct draw_command* cmd = list->cmd_count ? draw_list_command_last(list) : 0;
+    if (!cmd || cmd->elem_count || (cmd->instance_count && (cmd->texture.id != texture.id
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+                                                            || cmd->userdata.id != list->userdata.id
+#endif
+                                                            ))) {
+      cmd = draw_list_push_command(list, list->clip_rect, texture);
+      if (!cmd)
+        return;
+    } else if (!cmd->instance_count) {
+      cmd->texture = texture;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+      cmd->userdata = list->userdata;
+#endif
+    }
+    struct draw_instance* inst = (struct draw_instance*)
+        buffer_alloc(list->instances, buffer_allocation_type::BUFFER_FRONT, sizeof(*inst), alignof(struct draw_instance));
+    if (!inst)
+      return;
+    inst->rect = r;
+    inst->uv[0] = uva;
+    inst->uv[1] = uvc;
+    inst->rounding = std::min(rounding, std::min(std::abs(r.w), std::abs(r.h)) * 0.5f);
+    inst->thickness = thickness;
+    inst->color = color;
+    cmd->instance_count++;
+    list->instance_count++;
+  }
+  INTERN void
+  draw_list_add_shape_instance(struct draw_list* list, rectf r, float rounding,
+                               float thickness, struct color color) {
+    color.a = (std::uint8_t) ((float) color.a * list->config.global_alpha);
+    draw_list_add_instance(list, list->config.tex_null.texture, r, list->config.tex_null.uv,
+                           list->config.tex_null.uv, rounding, thickness, color);
+  }
   INTERN int
   draw_vertex_layout_element_is_end_of_layout(
       const struct draw_vertex_layout_element* element) {
@@ -439,6 +535,249 @@ namespace nk {
     }
     return result;
   }
+  INTERN void*
+  draw_vertex_generic(void* dst, const struct draw_list* list,
+                      const struct draw_vertex_input* src, const unsigned int count) {
+    for (unsigned int i = 0; i < count; ++i)
+      dst = draw_vertex(dst, &list->config, src[i].pos, src[i].uv, src[i].color);
+    return dst;
+  }
+  INTERN void*
+  draw_vertex_user(void* dst, const struct draw_list* list,
+                   const struct draw_vertex_input* src, const unsigned int count) {
+    for (unsigned int i = 0; i < count; ++i)
+      dst = list->vertex_writer(dst, list, src[i].pos, src[i].uv, src[i].color);
+    return dst;
+  }
+  template <enum draw_vertex_layout_format Format>
+  INTERN void*
+  draw_vertex_specialized(void* dst, const struct draw_list* list,
+                          const struct draw_vertex_input* src, const unsigned int count) {
+    std::byte* vtx = (std::byte*) dst;
+    const std::size_t position = list->position_offset;
+    const std::size_t texcoord = list->texcoord_offset;
+    const std::size_t color = list->color_offset;
+    const std::size_t size = list->config.vertex_size;
+    for (unsigned int i = 0; i < count; ++i, vtx += size) {
+      std::memcpy(vtx + position, &src[i].pos, sizeof(src[i].pos));
+      std::memcpy(vtx + texcoord, &src[i].uv, sizeof(src[i].uv));
+      draw_vertex_write_color<Format>(vtx + color, src[i].color);
+    }
+    return vtx;
+  }
+
+  /** collects tessellated vertices so `draw_list::block_writer` is called once per block */
+  struct draw_vertex_stage {
+    const struct draw_list* list;
+    void* dst;
+    unsigned int count;
+    struct draw_vertex_input block[NK_DRAW_VERTEX_BLOCK];
+  };
+  INTERN void
+  draw_vertex_stage_begin(struct draw_vertex_stage* stage, const struct draw_list* list, void* dst) {
+    stage->list = list;
+    stage->dst = dst;
+    stage->count = 0;
+  }
+  INTERN void
+  draw_vertex_stage_flush(struct draw_vertex_stage* stage) {
+    if (!stage->count)
+      return;
+    stage->dst = stage->list->block_writer(stage->dst, stage->list, stage->block, stage->count);
+    stage->count = 0;
+  }
+  INTERN void
+  draw_vertex_stage_push(struct draw_vertex_stage* stage, const vec2f pos, const vec2f uv, const struct colorf color) {
+    struct draw_vertex_input* v = &stage->block[stage->count++];
+    v->pos = pos;
+    v->uv = uv;
+    v->color = color;
+    if (stage->count == NK_DRAW_VERTEX_BLOCK)
+      draw_vertex_stage_flush(stage);
+  }
+  INTERN void
+  draw_list_select_writer(struct draw_list* list) {
+    /* layouts made of exactly one float position, one float texcoord and one
+     * common color format get a writer without the per-vertex layout walk */
+    const struct draw_vertex_layout_element* elem_iter = list->config.vertex_layout;
+    int position = 0, texcoord = 0, color = 0;
+    enum draw_vertex_layout_format color_format = NK_FORMAT_COUNT;
+
+    list->block_writer = draw_vertex_generic;
+    list->vertex_writer = 0;
+    if (!elem_iter)
+      return;
+    for (; !draw_vertex_layout_element_is_end_of_layout(elem_iter); ++elem_iter) {
+      switch (elem_iter->attribute) {
+        case NK_VERTEX_POSITION:
+          if (elem_iter->format != NK_FORMAT_FLOAT)
+            return;
+          list->position_offset = elem_iter->offset;
+          position++;
+          break;
+        case NK_VERTEX_TEXCOORD:
+          if (elem_iter->format != NK_FORMAT_FLOAT)
+            return;
+          list->texcoord_offset = elem_iter->offset;
+          texcoord++;
+          break;
+        case NK_VERTEX_COLOR:
+          list->color_offset = elem_iter->offset;
+          color_format = elem_iter->format;
+          color++;
+          break;
+        default:
+          return;
+      }
+    }
+    if (position != 1 || texcoord != 1 || color != 1)
+      return;
+
+    switch (color_format) {
+      default:
+        break;
+      case NK_FORMAT_R8G8B8A8:
+        list->block_writer = draw_vertex_specialized<NK_FORMAT_R8G8B8A8>;
+        break;
+      case NK_FORMAT_R8G8B8:
+        list->block_writer = draw_vertex_specialized<NK_FORMAT_R8G8B8>;
+        break;
+      case NK_FORMAT_B8G8R8A8:
+        list->block_writer = draw_vertex_specialized<NK_FORMAT_B8G8R8A8>;
+        break;
+      case NK_FORMAT_R32G32B32A32_FLOAT:
+        list->block_writer = draw_vertex_specialized<NK_FORMAT_R32G32B32A32_FLOAT>;
+        break;
+    }
+  }
+  INTERN float
+  draw_list_inv_len(const float len_sqr) {
+    /* same estimate and newton step as the SIMD lanes of `draw_list_segment_normals`,
+     * so a segment gets the same normal whether it falls into a lane or the tail */
+#ifdef NK_USE_SSE2
+    const float inv = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(len_sqr)));
+    return inv * (1.5f - (0.5f * len_sqr) * (inv * inv));
+#else
+    return NK_INV_SQRT(len_sqr);
+#endif
+  }
+  INTERN void
+  draw_list_segment_normals(vec2f* normals, const vec2f* points,
+                            const std::size_t count, const std::size_t points_count) {
+    /* normals[i] is the unit normal of the segment from points[i] to the next point */
+    std::size_t i = 0;
+#ifdef NK_USE_SSE2
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 threehalfs = _mm_set1_ps(1.5f);
+    for (; i + 4 <= count && i + 4 < points_count; i += 4) {
+      const float* p = &points[i].x;
+      const __m128 d0 = _mm_sub_ps(_mm_loadu_ps(p + 2), _mm_loadu_ps(p));
+      const __m128 d1 = _mm_sub_ps(_mm_loadu_ps(p + 6), _mm_loadu_ps(p + 4));
+      const __m128 dx = _mm_shuffle_ps(d0, d1, _MM_SHUFFLE(2, 0, 2, 0));
+      const __m128 dy = _mm_shuffle_ps(d0, d1, _MM_SHUFFLE(3, 1, 3, 1));
+
+      /* estimate refined by one newton step like `draw_list_inv_len` */
+      const __m128 len = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+      __m128 inv = _mm_rsqrt_ps(len);
+      inv = _mm_mul_ps(inv, _mm_sub_ps(threehalfs, _mm_mul_ps(_mm_mul_ps(half, len), _mm_mul_ps(inv, inv))));
+      const __m128 zero = _mm_cmpeq_ps(len, _mm_setzero_ps());
+      inv = _mm_or_ps(_mm_and_ps(zero, one), _mm_andnot_ps(zero, inv));
+
+      const __m128 nx = _mm_mul_ps(dy, inv);
+      const __m128 ny = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(dx, inv));
+      _mm_storeu_ps(&normals[i].x, _mm_unpacklo_ps(nx, ny));
+      _mm_storeu_ps(&normals[i + 2].x, _mm_unpackhi_ps(nx, ny));
+    }
+#endif
+    for (; i < count; ++i) {
+      const std::size_t next = ((i + 1) == points_count) ? 0 : (i + 1);
+      vec2f diff = vec2_sub(points[next], points[i]);
+
+      /* vec2 inverted length  */
+      float len = vec2_len_sqr(diff);
+      if (len != 0.0f)
+        len = draw_list_inv_len(len);
+      else
+        len = 1.0f;
+
+      diff = vec2_muls(diff, len);
+      normals[i].x = diff.y;
+      normals[i].y = -diff.x;
+    }
+  }
+  INTERN void
+  draw_list_miter_offsets(vec2f* miters, const vec2f* normals, const std::size_t count) {
+    /* miters[i] joins normals[i] and normals[i + 1], so `normals` needs count + 1 entries */
+    std::size_t i = 0;
+#ifdef NK_USE_SSE2
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 limit = _mm_set1_ps(100.0f);
+    const __m128 epsilon = _mm_set1_ps(0.000001f);
+    for (; i + 4 <= count; i += 4) {
+      const float* n = &normals[i].x;
+      const __m128 m0 = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(n), _mm_loadu_ps(n + 2)), half);
+      const __m128 m1 = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(n + 4), _mm_loadu_ps(n + 6)), half);
+      const __m128 mx = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(2, 0, 2, 0));
+      const __m128 my = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(3, 1, 3, 1));
+
+      const __m128 r2 = _mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my));
+      const __m128 valid = _mm_cmpgt_ps(r2, epsilon);
+      const __m128 scale = _mm_min_ps(limit, _mm_div_ps(one, _mm_or_ps(_mm_and_ps(valid, r2), _mm_andnot_ps(valid, one))));
+      const __m128 s = _mm_or_ps(_mm_and_ps(valid, scale), _mm_andnot_ps(valid, one));
+
+      const __m128 x = _mm_mul_ps(mx, s);
+      const __m128 y = _mm_mul_ps(my, s);
+      _mm_storeu_ps(&miters[i].x, _mm_unpacklo_ps(x, y));
+      _mm_storeu_ps(&miters[i + 2].x, _mm_unpackhi_ps(x, y));
+    }
+#endif
+    for (; i < count; ++i) {
+      vec2f dm = vec2_muls(vec2_add(normals[i], normals[i + 1]), 0.5f);
+      const float dmr2 = dm.x * dm.x + dm.y * dm.y;
+      if (dmr2 > 0.000001f) {
+        float scale = 1.0f / dmr2;
+        scale = std::min(100.0f, scale);
+        dm = vec2_muls(dm, scale);
+      }
+      miters[i] = dm;
+    }
+  }
+  INTERN void
+  draw_list_fringe_points(vec2f* fringe, const vec2f* points, const vec2f* miters,
+                          const std::size_t count, const std::size_t points_count,
+                          const float* widths, const std::size_t bands) {
+    /* miters[i] offsets the point after segment i, which gets `bands` points pushed out by
+     * widths[0..bands) followed by the same widths pulled in, in reverse order */
+    const std::size_t stride = bands * 2;
+    std::size_t i = 0;
+#ifdef NK_USE_SSE2
+    for (; i + 2 <= count && i + 2 < points_count; i += 2) {
+      const __m128 p = _mm_loadu_ps(&points[i + 1].x);
+      const __m128 m = _mm_loadu_ps(&miters[i].x);
+      float* a = &fringe[(i + 1) * stride].x;
+      float* b = &fringe[(i + 2) * stride].x;
+      for (std::size_t j = 0; j < bands; ++j) {
+        const __m128 d = _mm_mul_ps(m, _mm_set1_ps(widths[j]));
+        const __m128 out = _mm_add_ps(p, d);
+        const __m128 in = _mm_sub_ps(p, d);
+        _mm_storel_pi((__m64*) (a + j * 2), out);
+        _mm_storeh_pi((__m64*) (b + j * 2), out);
+        _mm_storel_pi((__m64*) (a + (stride - 1 - j) * 2), in);
+        _mm_storeh_pi((__m64*) (b + (stride - 1 - j) * 2), in);
+      }
+    }
+#endif
+    for (; i < count; ++i) {
+      const std::size_t next = ((i + 1) == points_count) ? 0 : (i + 1);
+      for (std::size_t j = 0; j < bands; ++j) {
+        const vec2f d = vec2_muls(miters[i], widths[j]);
+        fringe[next * stride + j] = vec2_add(points[next], d);
+        fringe[next * stride + stride - 1 - j] = vec2_sub(points[next], d);
+      }
+    }
+  }
   NK_API void
   draw_list_stroke_poly_line(struct draw_list* list, const vec2f* points,
                              const unsigned int points_count, struct color color, enum draw_list_stroke closed,
@@ -461,7 +800,6 @@ namespace nk {
     draw_list_push_userdata(list, list->userdata);
 #endif
 
-    color.a = (std::uint8_t) ((float) color.a * list->config.global_alpha);
     color_fv(&col.r, color);
     col_trans = col;
     col_trans.a = 0;
@@ -475,51 +813,38 @@ namespace nk {
       /* allocate vertices and elements  */
       std::size_t i1 = 0;
       std::size_t vertex_offset;
-      std::size_t index = list->vertex_count;
 
       const std::size_t idx_count = (thick_line) ? (count * 18) : (count * 12);
       const std::size_t vtx_count = (thick_line) ? (points_count * 4) : (points_count * 3);
+      std::size_t index = draw_list_vertex_index(list, vtx_count);
 
       void* vtx = draw_list_alloc_vertices(list, vtx_count);
       draw_index* ids = draw_list_alloc_elements(list, idx_count);
 
       std::size_t size;
-      vec2f *normals, *temp;
+      vec2f *normals, *miters, *temp;
       if (!vtx || !ids)
         return;
 
-      /* temporary allocate normals + points */
+      /* temporary allocate normals + miters + points */
       vertex_offset = (std::size_t) ((std::byte*) vtx - (std::byte*) list->vertices->memory.ptr);
       buffer_mark(list->vertices, buffer_allocation_type::BUFFER_FRONT);
-      size = pnt_size * ((thick_line) ? 5 : 3) * points_count;
+      size = pnt_size * (((thick_line) ? 6 : 4) * points_count + 1);
       normals = (vec2f*) buffer_alloc(list->vertices, buffer_allocation_type::BUFFER_FRONT, size, pnt_align);
       if (!normals)
         return;
-      temp = normals + points_count;
+      miters = normals + points_count + 1;
+      temp = miters + points_count;
 
       /* make sure vertex pointer is still correct */
       vtx = (void*) ((std::byte*) list->vertices->memory.ptr + vertex_offset);
 
-      /* calculate normals */
-      for (i1 = 0; i1 < count; ++i1) {
-        const std::size_t i2 = ((i1 + 1) == points_count) ? 0 : (i1 + 1);
-        vec2f diff = vec2_sub(points[i2], points[i1]);
-        float len;
-
-        /* vec2 inverted length  */
-        len = vec2_len_sqr(diff);
-        if (len != 0.0f)
-          len = NK_INV_SQRT(len);
-        else
-          len = 1.0f;
-
-        diff = vec2_muls(diff, len);
-        normals[i1].x = diff.y;
-        normals[i1].y = -diff.x;
-      }
-
+      /* calculate normals and the averaged miter offset at the end of every segment */
+      draw_list_segment_normals(normals, points, count, points_count);
       if (!closed)
         normals[points_count - 1] = normals[points_count - 2];
+      normals[points_count] = normals[0];
+      draw_list_miter_offsets(miters, normals, count);
 
       if (!thick_line) {
         std::size_t idx1, i;
@@ -532,27 +857,14 @@ namespace nk {
           temp[(points_count - 1) * 2 + 1] = vec2_sub(points[points_count - 1], d);
         }
 
+        /* fringe points around every segment end */
+        draw_list_fringe_points(temp, points, miters, count, points_count, &AA_SIZE, 1);
+
         /* fill elements */
         idx1 = index;
         for (i1 = 0; i1 < count; i1++) {
-          vec2f dm;
-          float dmr2;
-          std::size_t i2 = ((i1 + 1) == points_count) ? 0 : (i1 + 1);
           std::size_t idx2 = ((i1 + 1) == points_count) ? index : (idx1 + 3);
 
-          /* average normals */
-          dm = vec2_muls(vec2_add(normals[i1], normals[i2]), 0.5f);
-          dmr2 = dm.x * dm.x + dm.y * dm.y;
-          if (dmr2 > 0.000001f) {
-            float scale = 1.0f / dmr2;
-            scale = std::min(100.0f, scale);
-            dm = vec2_muls(dm, scale);
-          }
-
-          dm = vec2_muls(dm, AA_SIZE);
-          temp[i2 * 2 + 0] = vec2_add(points[i2], dm);
-          temp[i2 * 2 + 1] = vec2_sub(points[i2], dm);
-
           ids[0] = (draw_index) (idx2 + 0);
           ids[1] = (draw_index) (idx1 + 0);
           ids[2] = (draw_index) (idx1 + 2);
@@ -570,12 +882,15 @@ namespace nk {
         }
 
         /* fill vertices */
+        struct draw_vertex_stage stage;
+        draw_vertex_stage_begin(&stage, list, vtx);
         for (i = 0; i < points_count; ++i) {
           const vec2f uv = list->config.tex_null.uv;
-          vtx = draw_vertex(vtx, &list->config, points[i], uv, col);
-          vtx = draw_vertex(vtx, &list->config, temp[i * 2 + 0], uv, col_trans);
-          vtx = draw_vertex(vtx, &list->config, temp[i * 2 + 1], uv, col_trans);
+          draw_vertex_stage_push(&stage, points[i], uv, col);
+          draw_vertex_stage_push(&stage, temp[i * 2 + 0], uv, col_trans);
+          draw_vertex_stage_push(&stage, temp[i * 2 + 1], uv, col_trans);
         }
+        draw_vertex_stage_flush(&stage);
       } else {
         std::size_t idx1, i;
         const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
@@ -597,29 +912,15 @@ namespace nk {
           temp[(points_count - 1) * 4 + 3] = vec2_sub(points[points_count - 1], d1);
         }
 
+        /* outer fringe and inner edge points around every segment end */
+        const float widths[2] = {half_inner_thickness + AA_SIZE, half_inner_thickness};
+        draw_list_fringe_points(temp, points, miters, count, points_count, widths, 2);
+
         /* add all elements */
         idx1 = index;
         for (i1 = 0; i1 < count; ++i1) {
-          vec2f dm_out, dm_in;
-          const std::size_t i2 = ((i1 + 1) == points_count) ? 0 : (i1 + 1);
           std::size_t idx2 = ((i1 + 1) == points_count) ? index : (idx1 + 4);
 
-          /* average normals */
-          vec2f dm = vec2_muls(vec2_add(normals[i1], normals[i2]), 0.5f);
-          float dmr2 = dm.x * dm.x + dm.y * dm.y;
-          if (dmr2 > 0.000001f) {
-            float scale = 1.0f / dmr2;
-            scale = std::min(100.0f, scale);
-            dm = vec2_muls(dm, scale);
-          }
-
-          dm_out = vec2_muls(dm, ((half_inner_thickness) + AA_SIZE));
-          dm_in = vec2_muls(dm, half_inner_thickness);
-          temp[i2 * 4 + 0] = vec2_add(points[i2], dm_out);
-          temp[i2 * 4 + 1] = vec2_add(points[i2], dm_in);
-          temp[i2 * 4 + 2] = vec2_sub(points[i2], dm_in);
-          temp[i2 * 4 + 3] = vec2_sub(points[i2], dm_out);
-
           /* add indexes */
           ids[0] = (draw_index) (idx2 + 1);
           ids[1] = (draw_index) (idx1 + 1);
@@ -644,27 +945,32 @@ namespace nk {
         }
 
         /* add vertices */
+        struct draw_vertex_stage stage;
+        draw_vertex_stage_begin(&stage, list, vtx);
         for (i = 0; i < points_count; ++i) {
           const vec2f uv = list->config.tex_null.uv;
-          vtx = draw_vertex(vtx, &list->config, temp[i * 4 + 0], uv, col_trans);
-          vtx = draw_vertex(vtx, &list->config, temp[i * 4 + 1], uv, col);
-          vtx = draw_vertex(vtx, &list->config, temp[i * 4 + 2], uv, col);
-          vtx = draw_vertex(vtx, &list->config, temp[i * 4 + 3], uv, col_trans);
+          draw_vertex_stage_push(&stage, temp[i * 4 + 0], uv, col_trans);
+          draw_vertex_stage_push(&stage, temp[i * 4 + 1], uv, col);
+          draw_vertex_stage_push(&stage, temp[i * 4 + 2], uv, col);
+          draw_vertex_stage_push(&stage, temp[i * 4 + 3], uv, col_trans);
         }
+        draw_vertex_stage_flush(&stage);
       }
       /* free temporary normals + points */
       buffer_reset(list->vertices, buffer_allocation_type::BUFFER_FRONT);
     } else {
       /* NON ANTI-ALIASED STROKE */
       std::size_t i1 = 0;
-      std::size_t idx = list->vertex_count;
       const std::size_t idx_count = count * 6;
       const std::size_t vtx_count = count * 4;
+      std::size_t idx = draw_list_vertex_index(list, vtx_count);
       void* vtx = draw_list_alloc_vertices(list, vtx_count);
       draw_index* ids = draw_list_alloc_elements(list, idx_count);
       if (!vtx || !ids)
         return;
 
+      struct draw_vertex_stage stage;
+      draw_vertex_stage_begin(&stage, list, vtx);
       for (i1 = 0; i1 < count; ++i1) {
         float dx, dy;
         const vec2f uv = list->config.tex_null.uv;
@@ -686,10 +992,10 @@ namespace nk {
         dx = diff.x * (thickness * 0.5f);
         dy = diff.y * (thickness * 0.5f);
 
-        vtx = draw_vertex(vtx, &list->config, vec2_from_floats(p1.x + dy, p1.y - dx), uv, col);
-        vtx = draw_vertex(vtx, &list->config, vec2_from_floats(p2.x + dy, p2.y - dx), uv, col);
-        vtx = draw_vertex(vtx, &list->config, vec2_from_floats(p2.x - dy, p2.y + dx), uv, col);
-        vtx = draw_vertex(vtx, &list->config, vec2_from_floats(p1.x - dy, p1.y + dx), uv, col);
+        draw_vertex_stage_push(&stage, vec2_from_floats(p1.x + dy, p1.y - dx), uv, col);
+        draw_vertex_stage_push(&stage, vec2_from_floats(p2.x + dy, p2.y - dx), uv, col);
+        draw_vertex_stage_push(&stage, vec2_from_floats(p2.x - dy, p2.y + dx), uv, col);
+        draw_vertex_stage_push(&stage, vec2_from_floats(p1.x - dy, p1.y + dx), uv, col);
 
         ids[0] = (draw_index) (idx + 0);
         ids[1] = (draw_index) (idx + 1);
@@ -701,6 +1007,7 @@ namespace nk {
         ids += 6;
         idx += 4;
       }
+      draw_vertex_stage_flush(&stage);
     }
   }
   NK_API void
@@ -732,28 +1039,32 @@ namespace nk {
 
       const float AA_SIZE = 1.0f;
       std::size_t vertex_offset = 0;
-      std::size_t index = list->vertex_count;
 
       const std::size_t idx_count = (points_count - 2) * 3 + points_count * 6;
       const std::size_t vtx_count = (points_count * 2);
+      std::size_t index = draw_list_vertex_index(list, vtx_count);
 
       void* vtx = draw_list_alloc_vertices(list, vtx_count);
       draw_index* ids = draw_list_alloc_elements(list, idx_count);
 
       std::size_t size = 0;
       vec2f* normals = 0;
+      vec2f* miters = 0;
+      vec2f* fringe = 0;
       unsigned int vtx_inner_idx = (unsigned int) (index + 0);
       unsigned int vtx_outer_idx = (unsigned int) (index + 1);
       if (!vtx || !ids)
         return;
 
-      /* temporary allocate normals */
+      /* temporary allocate normals + miters + fringe points */
       vertex_offset = (std::size_t) ((std::byte*) vtx - (std::byte*) list->vertices->memory.ptr);
       buffer_mark(list->vertices, buffer_allocation_type::BUFFER_FRONT);
-      size = pnt_size * points_count;
+      size = pnt_size * (points_count * 4 + 1);
       normals = (vec2f*) buffer_alloc(list->vertices, buffer_allocation_type::BUFFER_FRONT, size, pnt_align);
       if (!normals)
         return;
+      miters = normals + points_count + 1;
+      fringe = miters + points_count;
       vtx = (void*) ((std::byte*) list->vertices->memory.ptr + vertex_offset);
 
       /* add elements */
@@ -764,41 +1075,24 @@ namespace nk {
         ids += 3;
       }
 
-      /* compute normals */
-      for (i0 = points_count - 1, i1 = 0; i1 < points_count; i0 = i1++) {
-        vec2f p0 = points[i0];
-        vec2f p1 = points[i1];
-        vec2f diff = vec2_sub(p1, p0);
-
-        /* vec2 inverted length  */
-        float len = vec2_len_sqr(diff);
-        if (len != 0.0f)
-          len = NK_INV_SQRT(len);
-        else
-          len = 1.0f;
-        diff = vec2_muls(diff, len);
+      /* compute normals and the miter offset of every point, miters[i0] belongs to point i1 */
+      draw_list_segment_normals(normals, points, points_count, points_count);
+      normals[points_count] = normals[0];
+      draw_list_miter_offsets(miters, normals, points_count);
 
-        normals[i0].x = diff.y;
-        normals[i0].y = -diff.x;
-      }
+      /* outer and inner fringe point of every point */
+      const float half_fringe = AA_SIZE * 0.5f;
+      draw_list_fringe_points(fringe, points, miters, points_count, points_count, &half_fringe, 1);
 
       /* add vertices + indexes */
+      struct draw_vertex_stage stage;
+      draw_vertex_stage_begin(&stage, list, vtx);
       for (i0 = points_count - 1, i1 = 0; i1 < points_count; i0 = i1++) {
         const vec2f uv = list->config.tex_null.uv;
-        vec2f n0 = normals[i0];
-        vec2f n1 = normals[i1];
-        vec2f dm = vec2_muls(vec2_add(n0, n1), 0.5f);
-        float dmr2 = dm.x * dm.x + dm.y * dm.y;
-        if (dmr2 > 0.000001f) {
-          float scale = 1.0f / dmr2;
-          scale = std::min(scale, 100.0f);
-          dm = vec2_muls(dm, scale);
-        }
-        dm = vec2_muls(dm, AA_SIZE * 0.5f);
 
         /* add vertices */
-        vtx = draw_vertex(vtx, &list->config, vec2_sub(points[i1], dm), uv, col);
-        vtx = draw_vertex(vtx, &list->config, vec2_add(points[i1], dm), uv, col_trans);
+        draw_vertex_stage_push(&stage, fringe[i1 * 2 + 1], uv, col);
+        draw_vertex_stage_push(&stage, fringe[i1 * 2 + 0], uv, col_trans);
 
         /* add indexes */
         ids[0] = (draw_index) (vtx_inner_idx + (i1 << 1));
@@ -809,20 +1103,24 @@ namespace nk {
         ids[5] = (draw_index) (vtx_inner_idx + (i1 << 1));
         ids += 6;
       }
+      draw_vertex_stage_flush(&stage);
       /* free temporary normals + points */
       buffer_reset(list->vertices, buffer_allocation_type::BUFFER_FRONT);
     } else {
       std::size_t i = 0;
-      std::size_t index = list->vertex_count;
       const std::size_t idx_count = (points_count - 2) * 3;
       const std::size_t vtx_count = points_count;
+      std::size_t index = draw_list_vertex_index(list, vtx_count);
       void* vtx = draw_list_alloc_vertices(list, vtx_count);
       draw_index* ids = draw_list_alloc_elements(list, idx_count);
 
       if (!vtx || !ids)
         return;
+      struct draw_vertex_stage stage;
+      draw_vertex_stage_begin(&stage, list, vtx);
       for (i = 0; i < vtx_count; ++i)
-        vtx = draw_vertex(vtx, &list->config, points[i], list->config.tex_null.uv, col);
+        draw_vertex_stage_push(&stage, points[i], list->config.tex_null.uv, col);
+      draw_vertex_stage_flush(&stage);
       for (i = 2; i < points_count; ++i) {
         ids[0] = (draw_index) index;
         ids[1] = (draw_index) (index + i - 1);
@@ -875,15 +1173,26 @@ namespace nk {
       }
     }
   }
-  NK_API void
-  draw_list_path_arc_to(struct draw_list* list, vec2f center,
-                        float radius, float a_min, float a_max, unsigned int segments) {
-    unsigned int i = 0;
-    NK_ASSERT(list);
-    if (!list)
-      return;
-    if (radius == 0.0f)
-      return;
+  INTERN const vec2f*
+  draw_list_unit_arc(struct draw_list* list, float a_min, float a_max, unsigned int segments) {
+    struct draw_arc_cache* cache = list->arcs;
+    const unsigned int count = segments + 1;
+    if (!cache || count > NK_DRAW_ARC_CACHE_POINTS)
+      return 0;
+
+    struct draw_arc_key {
+      float a_min, a_max;
+      unsigned int segments;
+    } key = {a_min, a_max, segments};
+    struct draw_arc_entry* entry = &cache->entries[murmur_hash(&key, (int) sizeof(key), 0) % NK_DRAW_ARC_CACHE_SIZE];
+    if (entry->count == count && entry->a_min == a_min && entry->a_max == a_max)
+      return cache->points + entry->offset;
+    if (cache->used + count > NK_DRAW_ARC_CACHE_POINTS) {
+      /* start over once the point pool is exhausted */
+      for (std::size_t i = 0; i < NK_LEN(cache->entries); ++i)
+        cache->entries[i].count = 0;
+      cache->used = 0;
+    }
 
     /*  This algorithm for arc drawing relies on these two trigonometric identities[1]:
             sin(a + b) = sin(a) * cos(b) + cos(a) * sin(b)
@@ -903,24 +1212,62 @@ namespace nk {
 
         [1] https://en.wikipedia.org/wiki/List_of_trigonometric_identities#Angle_sum_and_difference_identities
     */
-    {
-      const float d_angle = (a_max - a_min) / (float) segments;
-      const float sin_d = std::sinf(d_angle);
-      const float cos_d = std::cosf(d_angle);
-
-      float cx = std::cosf(a_min) * radius;
-      float cy = std::sinf(a_min) * radius;
-      for (i = 0; i <= segments; ++i) {
-        float new_cx, new_cy;
-        const float x = center.x + cx;
-        const float y = center.y + cy;
-        draw_list_path_line_to(list, vec2_from_floats(x, y));
+    vec2f* points = cache->points + cache->used;
+    const float d_angle = (a_max - a_min) / (float) segments;
+    const float sin_d = std::sinf(d_angle);
+    const float cos_d = std::cosf(d_angle);
+    float cx = std::cosf(a_min);
+    float cy = std::sinf(a_min);
+    for (unsigned int i = 0; i < count; ++i) {
+      points[i] = vec2_from_floats(cx, cy);
+      const float new_cx = cx * cos_d - cy * sin_d;
+      const float new_cy = cy * cos_d + cx * sin_d;
+      cx = new_cx;
+      cy = new_cy;
+    }
+    entry->a_min = a_min;
+    entry->a_max = a_max;
+    entry->offset = cache->used;
+    entry->count = count;
+    cache->used += count;
+    return points;
+  }
+  INTERN unsigned int
+  draw_list_circle_segments(float radius, unsigned int segments) {
+    /* the chord error r * (1 - cos(pi / n)) is about r * (pi / n)^2 / 2 */
+    const float needed = NK_PI * std::sqrt(std::abs(radius) / (2.0f * NK_CIRCLE_MAX_ERROR));
+    const unsigned int n = (unsigned int) std::ceil(std::min(needed, (float) segments));
+    return std::max(n, std::min(segments, 6u));
+  }
+  NK_API void
+  draw_list_path_arc_to(struct draw_list* list, vec2f center,
+                        float radius, float a_min, float a_max, unsigned int segments) {
+    NK_ASSERT(list);
+    if (!list)
+      return;
+    if (radius == 0.0f || !segments)
+      return;
 
-        new_cx = cx * cos_d - cy * sin_d;
-        new_cy = cy * cos_d + cx * sin_d;
-        cx = new_cx;
-        cy = new_cy;
-      }
+    const vec2f* unit = draw_list_unit_arc(list, a_min, a_max, segments);
+    if (unit) {
+      for (unsigned int i = 0; i <= segments; ++i)
+        draw_list_path_line_to(list, vec2_from_floats(center.x + unit[i].x * radius, center.y + unit[i].y * radius));
+      return;
+    }
+
+    /* too many segments to cache, rotate the previous point by the segment angle */
+    const float d_angle = (a_max - a_min) / (float) segments;
+    const float sin_d = std::sinf(d_angle);
+    const float cos_d = std::cosf(d_angle);
+
+    float cx = std::cosf(a_min) * radius;
+    float cy = std::sinf(a_min) * radius;
+    for (unsigned int i = 0; i <= segments; ++i) {
+      draw_list_path_line_to(list, vec2_from_floats(center.x + cx, center.y + cy));
+      const float new_cx = cx * cos_d - cy * sin_d;
+      const float new_cy = cy * cos_d + cx * sin_d;
+      cx = new_cx;
+      cy = new_cy;
     }
   }
   NK_API void
@@ -995,12 +1342,105 @@ namespace nk {
                                closed, thickness, list->config.line_AA);
     draw_list_path_clear(list);
   }
+  INTERN void
+  draw_list_push_rect_uv(struct draw_list* list, vec2f a,
+                         vec2f c, vec2f uva, vec2f uvc,
+                         struct color color) {
+    void* vtx;
+    vec2f uvb;
+    vec2f uvd;
+    vec2f b;
+    vec2f d;
+
+    struct colorf col;
+    draw_index* idx;
+    draw_index index;
+    NK_ASSERT(list);
+    if (!list)
+      return;
+
+    color_fv(&col.r, color);
+    uvb = vec2_from_floats(uvc.x, uva.y);
+    uvd = vec2_from_floats(uva.x, uvc.y);
+    b = vec2_from_floats(c.x, a.y);
+    d = vec2_from_floats(a.x, c.y);
+
+    index = (draw_index) draw_list_vertex_index(list, 4);
+    vtx = draw_list_alloc_vertices(list, 4);
+    idx = draw_list_alloc_elements(list, 6);
+    if (!vtx || !idx)
+      return;
+
+    idx[0] = (draw_index) (index + 0);
+    idx[1] = (draw_index) (index + 1);
+    idx[2] = (draw_index) (index + 2);
+    idx[3] = (draw_index) (index + 0);
+    idx[4] = (draw_index) (index + 2);
+    idx[5] = (draw_index) (index + 3);
+
+    const struct draw_vertex_input quad[4] = {{a, uva, col}, {b, uvb, col}, {c, uvc, col}, {d, uvd, col}};
+    list->block_writer(vtx, list, quad, 4);
+  }
+  INTERN bool
+  draw_list_is_pixel(const float v) {
+    return v == std::floor(v);
+  }
+  INTERN float
+  draw_list_snap_edge(const struct draw_list* list, const float center, const float half) {
+    /* moves `center` so the edge `half` before it lies on a whole pixel */
+    return list->config.pixel_snap ? std::round(center - half) + half : center;
+  }
+  INTERN void
+  draw_list_push_solid_rect(struct draw_list* list, float x0, float y0,
+                            float x1, float y1, struct color col) {
+    /* the fringe of a pixel aligned edge covers no pixel center, so a plain quad looks the same */
+    const vec2f uv = list->config.tex_null.uv;
+    if (!list->cmd_count)
+      draw_list_add_clip(list, null_rect);
+    /* like the path, never append to a command of another texture or of instances */
+    draw_list_push_image(list, list->config.tex_null.texture);
+    col.a = (std::uint8_t) ((float) col.a * list->config.global_alpha);
+    draw_list_push_rect_uv(list, vec2_from_floats(x0, y0), vec2_from_floats(x1, y1), uv, uv, col);
+  }
   NK_API void
   draw_list_stroke_line(struct draw_list* list, vec2f a,
                         vec2f b, struct color col, float thickness) {
     NK_ASSERT(list);
     if (!list || !col.a)
       return;
+    if (list->instances && (a.x == b.x || a.y == b.y)) {
+      /* axis aligned lines are filled rectangles without caps */
+      const float h = thickness * 0.5f;
+      const rectf r = (a.y == b.y) ? rect(std::min(a.x, b.x), a.y - h, std::abs(b.x - a.x), thickness)
+                                   : rect(a.x - h, std::min(a.y, b.y), thickness, std::abs(b.y - a.y));
+      draw_list_add_shape_instance(list, r, 0, 0, col);
+      return;
+    }
+    if ((a.x == b.x) != (a.y == b.y)) {
+      const float h = thickness * 0.5f;
+      if (a.y == b.y) {
+        a.y = b.y = draw_list_snap_edge(list, a.y, h);
+        if (list->config.pixel_snap) {
+          a.x = std::round(a.x);
+          b.x = std::round(b.x);
+        }
+      } else {
+        a.x = b.x = draw_list_snap_edge(list, a.x, h);
+        if (list->config.pixel_snap) {
+          a.y = std::round(a.y);
+          b.y = std::round(b.y);
+        }
+      }
+      const float x0 = (a.y == b.y) ? std::min(a.x, b.x) : a.x - h;
+      const float x1 = (a.y == b.y) ? std::max(a.x, b.x) : a.x + h;
+      const float y0 = (a.y == b.y) ? a.y - h : std::min(a.y, b.y);
+      const float y1 = (a.y == b.y) ? a.y + h : std::max(a.y, b.y);
+      if (list->line_AA == NK_ANTI_ALIASING_ON && draw_list_is_pixel(x0) && draw_list_is_pixel(x1) &&
+          draw_list_is_pixel(y0) && draw_list_is_pixel(y1)) {
+        draw_list_push_solid_rect(list, x0, y0, x1, y1, col);
+        return;
+      }
+    }
     if (list->line_AA == NK_ANTI_ALIASING_ON) {
       draw_list_path_line_to(list, a);
       draw_list_path_line_to(list, b);
@@ -1016,6 +1456,21 @@ namespace nk {
     NK_ASSERT(list);
     if (!list || !col.a)
       return;
+    if (list->instances) {
+      draw_list_add_shape_instance(list, rect, rounding, 0, col);
+      return;
+    }
+    if (rounding <= 0.0f) {
+      if (list->config.pixel_snap) {
+        const float x0 = std::round(rect.x), y0 = std::round(rect.y);
+        rect = nk::rect(x0, y0, std::round(rect.x + rect.w) - x0, std::round(rect.y + rect.h) - y0);
+      }
+      if (list->shape_AA == NK_ANTI_ALIASING_ON && draw_list_is_pixel(rect.x) && draw_list_is_pixel(rect.y) &&
+          draw_list_is_pixel(rect.x + rect.w) && draw_list_is_pixel(rect.y + rect.h)) {
+        draw_list_push_solid_rect(list, rect.x, rect.y, rect.x + rect.w, rect.y + rect.h, col);
+        return;
+      }
+    }
 
     if (list->line_AA == NK_ANTI_ALIASING_ON) {
       draw_list_path_rect_to(list, vec2_from_floats(rect.x, rect.y),
@@ -1032,6 +1487,28 @@ namespace nk {
     NK_ASSERT(list);
     if (!list || !col.a)
       return;
+    if (list->instances) {
+      draw_list_add_shape_instance(list, rect, rounding, thickness, col);
+      return;
+    }
+    if (rounding <= 0.0f) {
+      const float h = thickness * 0.5f;
+      const float x = draw_list_snap_edge(list, rect.x, h), y = draw_list_snap_edge(list, rect.y, h);
+      rect = nk::rect(x, y, draw_list_snap_edge(list, rect.x + rect.w, h) - x, draw_list_snap_edge(list, rect.y + rect.h, h) - y);
+
+      /* four bands which do not overlap so translucent borders blend once */
+      const float x0 = rect.x - h, y0 = rect.y - h;
+      const float x1 = rect.x + rect.w + h, y1 = rect.y + rect.h + h;
+      if (list->line_AA == NK_ANTI_ALIASING_ON && draw_list_is_pixel(x0) && draw_list_is_pixel(y0) &&
+          draw_list_is_pixel(x1) && draw_list_is_pixel(y1) && draw_list_is_pixel(thickness) &&
+          x1 - x0 > 2 * thickness && y1 - y0 > 2 * thickness) {
+        draw_list_push_solid_rect(list, x0, y0, x1, y0 + thickness, col);
+        draw_list_push_solid_rect(list, x0, y1 - thickness, x1, y1, col);
+        draw_list_push_solid_rect(list, x0, y0 + thickness, x0 + thickness, y1 - thickness, col);
+        draw_list_push_solid_rect(list, x1 - thickness, y0 + thickness, x1, y1 - thickness, col);
+        return;
+      }
+    }
     if (list->line_AA == NK_ANTI_ALIASING_ON) {
       draw_list_path_rect_to(list, vec2_from_floats(rect.x, rect.y),
                              vec2_from_floats(rect.x + rect.w, rect.y + rect.h), rounding);
@@ -1061,7 +1538,7 @@ namespace nk {
       return;
 
     draw_list_push_image(list, list->config.tex_null.texture);
-    index = (draw_index) list->vertex_count;
+    index = (draw_index) draw_list_vertex_index(list, 4);
     vtx = draw_list_alloc_vertices(list, 4);
     idx = draw_list_alloc_elements(list, 6);
     if (!vtx || !idx)
@@ -1074,10 +1551,12 @@ namespace nk {
     idx[4] = (draw_index) (index + 2);
     idx[5] = (draw_index) (index + 3);
 
-    vtx = draw_vertex(vtx, &list->config, vec2_from_floats(rect.x, rect.y), list->config.tex_null.uv, col_left);
-    vtx = draw_vertex(vtx, &list->config, vec2_from_floats(rect.x + rect.w, rect.y), list->config.tex_null.uv, col_top);
-    vtx = draw_vertex(vtx, &list->config, vec2_from_floats(rect.x + rect.w, rect.y + rect.h), list->config.tex_null.uv, col_right);
-    vtx = draw_vertex(vtx, &list->config, vec2_from_floats(rect.x, rect.y + rect.h), list->config.tex_null.uv, col_bottom);
+    const vec2f uv = list->config.tex_null.uv;
+    const struct draw_vertex_input quad[4] = {{vec2_from_floats(rect.x, rect.y), uv, col_left},
+                                              {vec2_from_floats(rect.x + rect.w, rect.y), uv, col_top},
+                                              {vec2_from_floats(rect.x + rect.w, rect.y + rect.h), uv, col_right},
+                                              {vec2_from_floats(rect.x, rect.y + rect.h), uv, col_bottom}};
+    list->block_writer(vtx, list, quad, 4);
   }
   NK_API void
   draw_list_fill_triangle(struct draw_list* list, vec2f a,
@@ -1108,6 +1587,11 @@ namespace nk {
     NK_ASSERT(list);
     if (!list || !col.a)
       return;
+    if (list->instances) {
+      draw_list_add_shape_instance(list, rect(center.x - radius, center.y - radius, radius * 2, radius * 2), radius, 0, col);
+      return;
+    }
+    segs = draw_list_circle_segments(radius, segs);
     a_max = NK_PI * 2.0f * ((float) segs - 1.0f) / (float) segs;
     draw_list_path_arc_to(list, center, radius, 0.0f, a_max, segs);
     draw_list_path_fill(list, col);
@@ -1119,6 +1603,11 @@ namespace nk {
     NK_ASSERT(list);
     if (!list || !col.a)
       return;
+    if (list->instances) {
+      draw_list_add_shape_instance(list, rect(center.x - radius, center.y - radius, radius * 2, radius * 2), radius, thickness, col);
+      return;
+    }
+    segs = draw_list_circle_segments(radius, segs);
     a_max = NK_PI * 2.0f * ((float) segs - 1.0f) / (float) segs;
     draw_list_path_arc_to(list, center, radius, 0.0f, a_max, segs);
     draw_list_path_stroke(list, col, NK_STROKE_CLOSED, thickness);
@@ -1134,71 +1623,34 @@ namespace nk {
     draw_list_path_curve_to(list, cp0, cp1, p1, segments);
     draw_list_path_stroke(list, col, NK_STROKE_OPEN, thickness);
   }
-  INTERN void
-  draw_list_push_rect_uv(struct draw_list* list, vec2f a,
-                         vec2f c, vec2f uva, vec2f uvc,
-                         struct color color) {
-    void* vtx;
-    vec2f uvb;
-    vec2f uvd;
-    vec2f b;
-    vec2f d;
-
-    struct colorf col;
-    draw_index* idx;
-    draw_index index;
-    NK_ASSERT(list);
-    if (!list)
-      return;
-
-    color_fv(&col.r, color);
-    uvb = vec2_from_floats(uvc.x, uva.y);
-    uvd = vec2_from_floats(uva.x, uvc.y);
-    b = vec2_from_floats(c.x, a.y);
-    d = vec2_from_floats(a.x, c.y);
-
-    index = (draw_index) list->vertex_count;
-    vtx = draw_list_alloc_vertices(list, 4);
-    idx = draw_list_alloc_elements(list, 6);
-    if (!vtx || !idx)
-      return;
-
-    idx[0] = (draw_index) (index + 0);
-    idx[1] = (draw_index) (index + 1);
-    idx[2] = (draw_index) (index + 2);
-    idx[3] = (draw_index) (index + 0);
-    idx[4] = (draw_index) (index + 2);
-    idx[5] = (draw_index) (index + 3);
-
-    vtx = draw_vertex(vtx, &list->config, a, uva, col);
-    vtx = draw_vertex(vtx, &list->config, b, uvb, col);
-    vtx = draw_vertex(vtx, &list->config, c, uvc, col);
-    vtx = draw_vertex(vtx, &list->config, d, uvd, col);
-  }
   NK_API void
   draw_list_add_image(struct draw_list* list, struct image texture,
                       rectf rect, struct color color) {
     NK_ASSERT(list);
     if (!list)
       return;
-    /* push new command with given texture */
-    draw_list_push_image(list, texture.handle);
+    vec2f uv[2];
     if (image_is_subimage(&texture)) {
       /* add region inside of the texture  */
-      vec2f uv[2];
       uv[0].x = (float) texture.region[0] / (float) texture.w;
       uv[0].y = (float) texture.region[1] / (float) texture.h;
       uv[1].x = (float) (texture.region[0] + texture.region[2]) / (float) texture.w;
       uv[1].y = (float) (texture.region[1] + texture.region[3]) / (float) texture.h;
-      draw_list_push_rect_uv(list, vec2_from_floats(rect.x, rect.y),
-                             vec2_from_floats(rect.x + rect.w, rect.y + rect.h), uv[0], uv[1], color);
-    } else
-      draw_list_push_rect_uv(list, vec2_from_floats(rect.x, rect.y),
-                             vec2_from_floats(rect.x + rect.w, rect.y + rect.h),
-                             vec2_from_floats(0.0f, 0.0f), vec2_from_floats(1.0f, 1.0f), color);
-  }
-  NK_API void
-  draw_list_add_text(struct draw_list* list, const struct user_font* font,
+    } else {
+      uv[0] = vec2_from_floats(0.0f, 0.0f);
+      uv[1] = vec2_from_floats(1.0f, 1.0f);
+    }
+    if (list->instances) {
+      draw_list_add_instance(list, texture.handle, rect, uv[0], uv[1], 0, 0, color);
+      return;
+    }
+    /* push new command with given texture */
+    draw_list_push_image(list, texture.handle);
+    draw_list_push_rect_uv(list, vec2_from_floats(rect.x, rect.y),
+                           vec2_from_floats(rect.x + rect.w, rect.y + rect.h), uv[0], uv[1], color);
+  }
+  NK_API void
+  draw_list_add_text(struct draw_list* list, const struct user_font* font,
                      rectf rect, const char* text, int len, float font_height,
                      struct color fg) {
     float x = 0;
@@ -1216,7 +1668,8 @@ namespace nk {
                    list->clip_rect.x, list->clip_rect.y, list->clip_rect.w, list->clip_rect.h))
       return;
 
-    draw_list_push_image(list, font->texture);
+    if (!list->instances)
+      draw_list_push_image(list, font->texture);
     x = rect.x;
     glyph_len = utf_decode(text, &unicode, len);
     if (!glyph_len)
@@ -1241,8 +1694,11 @@ namespace nk {
       gw = g.width;
       gh = g.height;
       char_width = g.xadvance;
-      draw_list_push_rect_uv(list, vec2_from_floats(gx, gy), vec2_from_floats(gx + gw, gy + gh),
-                             g.uv[0], g.uv[1], fg);
+      if (list->instances)
+        draw_list_add_instance(list, font->texture, nk::rect(gx, gy, gw, gh), g.uv[0], g.uv[1], 0, 0, fg);
+      else
+        draw_list_push_rect_uv(list, vec2_from_floats(gx, gy), vec2_from_floats(gx + gw, gy + gh),
+                               g.uv[0], g.uv[1], fg);
 
       /* offset next glyph */
       text_len += glyph_len;
@@ -1251,10 +1707,588 @@ namespace nk {
       unicode = next;
     }
   }
+  INTERN flag
+  convert_result(const memory_buffer* cmds, const memory_buffer* vertices, const memory_buffer* elements) {
+    flag res = 0;
+    res |= (cmds->needed > cmds->allocated + (cmds->memory.size - cmds->size)) ? NK_CONVERT_COMMAND_BUFFER_FULL : 0;
+    res |= (vertices->needed > vertices->allocated) ? NK_CONVERT_VERTEX_BUFFER_FULL : 0;
+    res |= (elements->needed > elements->allocated) ? NK_CONVERT_ELEMENT_BUFFER_FULL : 0;
+    return res;
+  }
+  INTERN void
+  convert_command(struct draw_list* list, const struct command* cmd,
+                  const struct convert_config* config) {
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+    list->userdata = cmd->userdata;
+#endif
+    switch (cmd->type) {
+      case command_type::COMMAND_NOP:
+        break;
+      case command_type::COMMAND_SCISSOR: {
+        const struct command_scissor* s = (const struct command_scissor*) cmd;
+        draw_list_add_clip(list, rect(s->x, s->y, s->w, s->h));
+      } break;
+      case command_type::COMMAND_LINE: {
+        const struct command_line* l = (const struct command_line*) cmd;
+        draw_list_stroke_line(list, vec2_from_floats(l->begin.x, l->begin.y),
+                              vec2_from_floats(l->end.x, l->end.y), l->color, l->line_thickness);
+      } break;
+      case command_type::COMMAND_CURVE: {
+        const struct command_curve* q = (const struct command_curve*) cmd;
+        draw_list_stroke_curve(list, vec2_from_floats(q->begin.x, q->begin.y),
+                               vec2_from_floats(q->ctrl[0].x, q->ctrl[0].y), vec2_from_floats(q->ctrl[1].x, q->ctrl[1].y), vec2_from_floats(q->end.x, q->end.y), q->color,
+                               config->curve_segment_count, q->line_thickness);
+      } break;
+      case command_type::COMMAND_RECT: {
+        const struct command_rect* r = (const struct command_rect*) cmd;
+        draw_list_stroke_rect(list, rect(r->x, r->y, r->w, r->h),
+                              r->color, (float) r->rounding, r->line_thickness);
+      } break;
+      case command_type::COMMAND_RECT_FILLED: {
+        const struct command_rect_filled* r = (const struct command_rect_filled*) cmd;
+        draw_list_fill_rect(list, rect(r->x, r->y, r->w, r->h),
+                            r->color, (float) r->rounding);
+      } break;
+      case command_type::COMMAND_RECT_MULTI_COLOR: {
+        const struct command_rect_multi_color* r = (const struct command_rect_multi_color*) cmd;
+        draw_list_fill_rect_multi_color(list, rect(r->x, r->y, r->w, r->h),
+                                        r->left, r->top, r->right, r->bottom);
+      } break;
+      case command_type::COMMAND_CIRCLE: {
+        const struct command_circle* c = (const struct command_circle*) cmd;
+        draw_list_stroke_circle(list, vec2_from_floats((float) c->x + (float) c->w / 2, (float) c->y + (float) c->h / 2), (float) c->w / 2, c->color,
+                                config->circle_segment_count, c->line_thickness);
+      } break;
+      case command_type::COMMAND_CIRCLE_FILLED: {
+        const struct command_circle_filled* c = (const struct command_circle_filled*) cmd;
+        draw_list_fill_circle(list, vec2_from_floats((float) c->x + (float) c->w / 2, (float) c->y + (float) c->h / 2), (float) c->w / 2, c->color,
+                              config->circle_segment_count);
+      } break;
+      case command_type::COMMAND_ARC: {
+        const struct command_arc* c = (const struct command_arc*) cmd;
+        draw_list_path_line_to(list, vec2_from_floats(c->cx, c->cy));
+        draw_list_path_arc_to(list, vec2_from_floats(c->cx, c->cy), c->r,
+                              c->a[0], c->a[1], config->arc_segment_count);
+        draw_list_path_stroke(list, c->color, NK_STROKE_CLOSED, c->line_thickness);
+      } break;
+      case command_type::COMMAND_ARC_FILLED: {
+        const struct command_arc_filled* c = (const struct command_arc_filled*) cmd;
+        draw_list_path_line_to(list, vec2_from_floats(c->cx, c->cy));
+        draw_list_path_arc_to(list, vec2_from_floats(c->cx, c->cy), c->r,
+                              c->a[0], c->a[1], config->arc_segment_count);
+        draw_list_path_fill(list, c->color);
+      } break;
+      case command_type::COMMAND_TRIANGLE: {
+        const struct command_triangle* t = (const struct command_triangle*) cmd;
+        draw_list_stroke_triangle(list, vec2_from_floats(t->a.x, t->a.y),
+                                  vec2_from_floats(t->b.x, t->b.y), vec2_from_floats(t->c.x, t->c.y), t->color,
+                                  t->line_thickness);
+      } break;
+      case command_type::COMMAND_TRIANGLE_FILLED: {
+        const struct command_triangle_filled* t = (const struct command_triangle_filled*) cmd;
+        draw_list_fill_triangle(list, vec2_from_floats(t->a.x, t->a.y),
+                                vec2_from_floats(t->b.x, t->b.y), vec2_from_floats(t->c.x, t->c.y), t->color);
+      } break;
+      case command_type::COMMAND_POLYGON: {
+        int i;
+        const struct command_polygon* p = (const struct command_polygon*) cmd;
+        for (i = 0; i < p->point_count; ++i) {
+          vec2f pnt = vec2_from_floats((float) p->points[i].x, (float) p->points[i].y);
+          draw_list_path_line_to(list, pnt);
+        }
+        draw_list_path_stroke(list, p->color, NK_STROKE_CLOSED, p->line_thickness);
+      } break;
+      case command_type::COMMAND_POLYGON_FILLED: {
+        int i;
+        const struct command_polygon_filled* p = (const struct command_polygon_filled*) cmd;
+        for (i = 0; i < p->point_count; ++i) {
+          vec2f pnt = vec2_from_floats((float) p->points[i].x, (float) p->points[i].y);
+          draw_list_path_line_to(list, pnt);
+        }
+        draw_list_path_fill(list, p->color);
+      } break;
+      case command_type::COMMAND_POLYLINE: {
+        int i;
+        const struct command_polyline* p = (const struct command_polyline*) cmd;
+        for (i = 0; i < p->point_count; ++i) {
+          vec2f pnt = vec2_from_floats((float) p->points[i].x, (float) p->points[i].y);
+          draw_list_path_line_to(list, pnt);
+        }
+        draw_list_path_stroke(list, p->color, NK_STROKE_OPEN, p->line_thickness);
+      } break;
+      case command_type::COMMAND_TEXT: {
+        const struct command_text* t = (const struct command_text*) cmd;
+        draw_list_add_text(list, t->font, rect(t->x, t->y, t->w, t->h),
+                           t->string, t->length, t->height, t->foreground);
+      } break;
+      case command_type::COMMAND_IMAGE: {
+        const struct command_image* i = (const struct command_image*) cmd;
+        draw_list_add_image(list, i->img, rect(i->x, i->y, i->w, i->h), i->col);
+      } break;
+      case command_type::COMMAND_CUSTOM: {
+        const struct command_custom* c = (const struct command_custom*) cmd;
+        c->callback(list, c->x, c->y, c->w, c->h, c->callback_data);
+      } break;
+      default:
+        break;
+    }
+  }
+  INTERN void
+  convert_segment(const struct context* ctx, struct draw_list* list,
+                  std::size_t offset, const std::size_t last, const struct convert_config* config) {
+    /* converts linked commands from `offset` up to and including `last` */
+    const std::uint8_t* memory = (const std::uint8_t*) ctx->memory.memory.ptr;
+    while (1) {
+      const struct command* cmd = ptr_add_const(struct command, memory, offset);
+      convert_command(list, cmd, config);
+      if (offset == last || cmd->next <= offset || cmd->next >= ctx->memory.allocated)
+        break;
+      offset = cmd->next;
+    }
+  }
+  INTERN void
+  draw_cache_frame_clear(struct draw_cache_frame* frame) {
+    buffer_clear(&frame->entries);
+    buffer_clear(&frame->vertices);
+    buffer_clear(&frame->elements);
+    buffer_clear(&frame->commands);
+    frame->entry_count = 0;
+  }
+  NK_API void
+  draw_cache_init(struct draw_cache* cache, const struct allocator* alloc) {
+    NK_ASSERT(cache);
+    NK_ASSERT(alloc);
+    if (!cache || !alloc)
+      return;
+    zero_struct(*cache);
+    for (std::size_t i = 0; i < NK_LEN(cache->frames); ++i) {
+      buffer_init(&cache->frames[i].entries, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      buffer_init(&cache->frames[i].vertices, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      buffer_init(&cache->frames[i].elements, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      buffer_init(&cache->frames[i].commands, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    }
+  }
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+  NK_API void
+  draw_cache_init_default(struct draw_cache* cache) {
+    struct allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = malloc;
+    alloc.free = mfree;
+    draw_cache_init(cache, &alloc);
+  }
+#endif
+  NK_API void
+  draw_cache_clear(struct draw_cache* cache) {
+    NK_ASSERT(cache);
+    if (!cache)
+      return;
+    for (std::size_t i = 0; i < NK_LEN(cache->frames); ++i)
+      draw_cache_frame_clear(&cache->frames[i]);
+  }
+  NK_API void
+  draw_cache_free(struct draw_cache* cache) {
+    NK_ASSERT(cache);
+    if (!cache)
+      return;
+    for (std::size_t i = 0; i < NK_LEN(cache->frames); ++i) {
+      buffer_free(&cache->frames[i].entries);
+      buffer_free(&cache->frames[i].vertices);
+      buffer_free(&cache->frames[i].elements);
+      buffer_free(&cache->frames[i].commands);
+    }
+    zero_struct(*cache);
+  }
+  INTERN const struct draw_cache_entry*
+  draw_cache_find(const struct draw_cache_frame* frame, const window* win, const unsigned int hint) {
+    /* windows mostly keep their order so try the same position first */
+    const struct draw_cache_entry* entries = (const struct draw_cache_entry*) buffer_memory_const(&frame->entries);
+    if (hint < frame->entry_count && entries[hint].name == win->name)
+      return &entries[hint];
+    for (unsigned int i = 0; i < frame->entry_count; ++i) {
+      if (entries[i].name == win->name)
+        return &entries[i];
+    }
+    return 0;
+  }
+  INTERN void
+  draw_cache_replay(struct draw_list* list, const struct draw_cache_frame* frame,
+                    const struct draw_cache_entry* entry) {
+    const std::uint8_t* vertices = (const std::uint8_t*) buffer_memory_const(&frame->vertices);
+    const std::uint8_t* elements = (const std::uint8_t*) buffer_memory_const(&frame->elements);
+    const std::uint8_t* commands = (const std::uint8_t*) buffer_memory_const(&frame->commands);
+    const unsigned int first = list->vertex_count;
+    const bool rebase = draw_list_needs_rebase(list, entry->vertex_count);
+    draw_index* ids = 0;
+
+    if (entry->vertex_count) {
+      void* vtx = draw_list_alloc_vertices(list, entry->vertex_count);
+      if (vtx)
+        std::memcpy(vtx, vertices + entry->vertex_offset, list->config.vertex_size * entry->vertex_count);
+    }
+    if (entry->element_count) {
+      /* elements are added directly since the commands already know their count */
+      ids = (draw_index*) buffer_alloc(list->elements, buffer_allocation_type::BUFFER_FRONT,
+                                       sizeof(draw_index) * entry->element_count, alignof(draw_index));
+      if (ids)
+        list->element_count += entry->element_count;
+    }
+    const draw_index* src_ids = (const draw_index*) (elements + entry->element_offset);
+    const struct draw_command* src = (const struct draw_command*) (commands + entry->command_offset);
+    for (unsigned int i = 0; i < entry->command_count; ++i) {
+      /* stored command bases are relative to the first window vertex. A command that began before
+       * the window has a negative base, it starts at the window and its elements are moved down instead */
+      if (rebase)
+        list->vertex_base = ((int) src[i].vertex_offset < 0) ? first : src[i].vertex_offset + first;
+      struct draw_command* cmd = draw_list_push_command(list, src[i].clip_rect, src[i].texture);
+      if (!cmd)
+        break;
+      cmd->elem_count = src[i].elem_count;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+      cmd->userdata = src[i].userdata;
+#endif
+      if (ids) {
+        draw_list_copy_elements(ids, src_ids, cmd->elem_count, src[i].vertex_offset + first - list->vertex_base);
+        ids += cmd->elem_count;
+      }
+      src_ids += cmd->elem_count;
+    }
+  }
+  INTERN void
+  draw_cache_store(struct draw_cache_frame* frame, const struct draw_list* list, const window* win,
+                   const unsigned int cmd_begin, const unsigned int vtx_begin, const unsigned int elem_begin) {
+    struct draw_cache_entry entry;
+    zero_struct(entry);
+    entry.name = win->name;
+    entry.commands = win->command_hash;
+    entry.vertex_count = list->vertex_count - vtx_begin;
+    entry.element_count = list->element_count - elem_begin;
+    entry.command_count = list->cmd_count - cmd_begin;
+
+    if (entry.vertex_count) {
+      const std::size_t size = list->config.vertex_size * entry.vertex_count;
+      std::uint8_t* vtx = (std::uint8_t*) buffer_alloc(&frame->vertices, buffer_allocation_type::BUFFER_FRONT,
+                                                       size, list->config.vertex_alignment);
+      if (!vtx)
+        return;
+      entry.vertex_offset = (std::size_t) (vtx - (std::uint8_t*) buffer_memory(&frame->vertices));
+      std::memcpy(vtx, (const std::uint8_t*) buffer_memory_const(list->vertices) + list->config.vertex_size * vtx_begin, size);
+    }
+    if (entry.element_count) {
+      /* elements stay relative to the base vertex of their command */
+      draw_index* ids = (draw_index*) buffer_alloc(&frame->elements, buffer_allocation_type::BUFFER_FRONT,
+                                                   sizeof(draw_index) * entry.element_count, alignof(draw_index));
+      if (!ids)
+        return;
+      entry.element_offset = (std::size_t) ((std::uint8_t*) ids - (std::uint8_t*) buffer_memory(&frame->elements));
+      const draw_index* src = (const draw_index*) buffer_memory_const(list->elements) + elem_begin;
+      std::memcpy(ids, src, sizeof(draw_index) * entry.element_count);
+    }
+    if (entry.command_count) {
+      /* draw commands are stored back to front inside the output buffer */
+      struct draw_command* cmds = (struct draw_command*) buffer_alloc(&frame->commands, buffer_allocation_type::BUFFER_FRONT,
+                                                                     sizeof(struct draw_command) * entry.command_count, alignof(struct draw_command));
+      if (!cmds)
+        return;
+      entry.command_offset = (std::size_t) ((std::uint8_t*) cmds - (std::uint8_t*) buffer_memory(&frame->commands));
+      const std::uint8_t* memory = (const std::uint8_t*) buffer_memory_const(list->buffer);
+      const struct draw_command* first = ptr_add_const(struct draw_command, memory, buffer_total(list->buffer) - list->cmd_offset);
+      for (unsigned int i = 0; i < entry.command_count; ++i) {
+        /* base vertices are stored relative to the first window vertex and may wrap */
+        cmds[i] = *(first - (cmd_begin + i));
+        cmds[i].vertex_offset -= vtx_begin;
+      }
+    }
+    struct draw_cache_entry* dst = (struct draw_cache_entry*) buffer_alloc(&frame->entries, buffer_allocation_type::BUFFER_FRONT,
+                                                                           sizeof(entry), alignof(struct draw_cache_entry));
+    if (!dst)
+      return;
+    *dst = entry;
+    frame->entry_count++;
+  }
+  INTERN hash
+  convert_config_hash(const struct convert_config* config) {
+    /* hashed field by field since the padding between them is indeterminate,
+     * `cache` and `batch` do not change the produced vertices */
+    hash h = murmur_hash(&config->global_alpha, (int) sizeof(config->global_alpha), 0);
+    h = murmur_hash(&config->line_AA, (int) sizeof(config->line_AA), h);
+    h = murmur_hash(&config->shape_AA, (int) sizeof(config->shape_AA), h);
+    h = murmur_hash(&config->circle_segment_count, (int) sizeof(config->circle_segment_count), h);
+    h = murmur_hash(&config->arc_segment_count, (int) sizeof(config->arc_segment_count), h);
+    h = murmur_hash(&config->curve_segment_count, (int) sizeof(config->curve_segment_count), h);
+    h = murmur_hash(&config->tex_null.texture.ptr, (int) sizeof(config->tex_null.texture.ptr), h);
+    h = murmur_hash(&config->tex_null.uv, (int) sizeof(config->tex_null.uv), h);
+    for (const struct draw_vertex_layout_element* it = config->vertex_layout;
+         it && !draw_vertex_layout_element_is_end_of_layout(it); ++it) {
+      h = murmur_hash(&it->attribute, (int) sizeof(it->attribute), h);
+      h = murmur_hash(&it->format, (int) sizeof(it->format), h);
+      h = murmur_hash(&it->offset, (int) sizeof(it->offset), h);
+    }
+    h = murmur_hash(&config->vertex_size, (int) sizeof(config->vertex_size), h);
+    h = murmur_hash(&config->vertex_alignment, (int) sizeof(config->vertex_alignment), h);
+    const std::uint8_t pixel_snap = config->pixel_snap;
+    return murmur_hash(&pixel_snap, (int) sizeof(pixel_snap), h);
+  }
+  INTERN void
+  convert_cached(struct context* ctx, struct draw_cache* cache,
+                 const struct convert_config* config) {
+    struct draw_list* list = &ctx->draw_list;
+    const std::uint8_t* memory = (const std::uint8_t*) ctx->memory.memory.ptr;
+    const struct command* last = 0;
+    const struct command* cmd = _begin(ctx);
+    if (!cmd)
+      return;
+
+    /* a different configuration produces different vertices */
+    const hash config_hash = convert_config_hash(config);
+    if (config_hash != cache->config) {
+      draw_cache_clear(cache);
+      cache->config = config_hash;
+    }
+    const struct draw_cache_frame* prev = &cache->frames[cache->current];
+    struct draw_cache_frame* next = &cache->frames[!cache->current];
+    draw_cache_frame_clear(next);
+
+    unsigned int index = 0;
+    for (window* it = ctx->begin; it; it = it->next) {
+      if (it->buffer.last == it->buffer.begin || (it->flags & static_cast<decltype(it->flags)>(window_flags::WINDOW_HIDDEN)) ||
+          it->seq != ctx->seq)
+        continue;
+
+      const unsigned int cmd_begin = list->cmd_count;
+      const unsigned int vtx_begin = list->vertex_count;
+      const unsigned int elem_begin = list->element_count;
+      const struct draw_cache_entry* entry = draw_cache_find(prev, it, index++);
+      if (entry && entry->commands == it->command_hash) {
+        draw_cache_replay(list, prev, entry);
+      } else {
+        /* start a new draw command so no window output depends on the previous window */
+        draw_list_push_command(list, null_rect, config->tex_null.texture);
+        convert_segment(ctx, list, it->buffer.begin, it->buffer.last, config);
+      }
+      last = ptr_add_const(struct command, memory, it->buffer.last);
+
+      /* only cache complete output */
+      if (!convert_result(list->buffer, list->vertices, list->elements))
+        draw_cache_store(next, list, it, cmd_begin, vtx_begin, elem_begin);
+    }
+    /* popups and overlay are converted every frame */
+    for (cmd = last ? _next(ctx, last) : 0; cmd; cmd = _next(ctx, cmd))
+      convert_command(list, cmd, config);
+    cache->current = !cache->current;
+  }
+  NK_API void
+  draw_batch_init(struct draw_batch* batch, const struct allocator* alloc) {
+    NK_ASSERT(batch);
+    NK_ASSERT(alloc);
+    if (!batch || !alloc)
+      return;
+    zero_struct(*batch);
+    buffer_init(&batch->scratch, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  }
+#ifdef NK_INCLUDE_DEFAULT_ALLOCATOR
+  NK_API void
+  draw_batch_init_default(struct draw_batch* batch) {
+    struct allocator alloc;
+    alloc.userdata.ptr = 0;
+    alloc.alloc = malloc;
+    alloc.free = mfree;
+    draw_batch_init(batch, &alloc);
+  }
+#endif
+  NK_API void
+  draw_batch_free(struct draw_batch* batch) {
+    NK_ASSERT(batch);
+    if (!batch)
+      return;
+    buffer_free(&batch->scratch);
+    zero_struct(*batch);
+  }
+  /** output draw command and the linked source commands merged into it */
+  struct draw_batch_group {
+    struct draw_command cmd;
+    rectf bounds;
+    unsigned int first;
+    unsigned int last;
+  };
+  INTERN bool
+  draw_batch_position(const struct draw_list* list, std::size_t* offset) {
+    const draw_vertex_layout_element* it = list->config.vertex_layout;
+    for (; it && !draw_vertex_layout_element_is_end_of_layout(it); ++it) {
+      if (it->attribute != NK_VERTEX_POSITION)
+        continue;
+      *offset = it->offset;
+      return it->format == NK_FORMAT_FLOAT;
+    }
+    return false;
+  }
+  INTERN rectf
+  draw_batch_bounds(const struct draw_list* list, const struct draw_command* cmd,
+                    const draw_index* elements, const bool has_position, const std::size_t position) {
+    /* without float positions the scissor rectangle is the only known bound */
+    rectf clip = cmd->clip_rect;
+    if (has_position && !cmd->instance_count) {
+      const std::uint8_t* vertices = (const std::uint8_t*) buffer_memory_const(list->vertices);
+      float x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+      for (unsigned int i = 0; i < cmd->elem_count; ++i) {
+        const std::size_t vertex = (std::size_t) cmd->vertex_offset + elements[i];
+        float pos[2];
+        std::memcpy(pos, vertices + vertex * list->config.vertex_size + position, sizeof(pos));
+        x0 = i ? std::min(x0, pos[0]) : pos[0];
+        y0 = i ? std::min(y0, pos[1]) : pos[1];
+        x1 = i ? std::max(x1, pos[0]) : pos[0];
+        y1 = i ? std::max(y1, pos[1]) : pos[1];
+      }
+      clip.x = std::max(x0, cmd->clip_rect.x);
+      clip.y = std::max(y0, cmd->clip_rect.y);
+      clip.w = std::min(x1, cmd->clip_rect.x + cmd->clip_rect.w) - clip.x;
+      clip.h = std::min(y1, cmd->clip_rect.y + cmd->clip_rect.h) - clip.y;
+    }
+    return clip;
+  }
+  INTERN bool
+  draw_batch_overlaps(const rectf a, const rectf b) {
+    /* touching counts since anti-aliased edges blend into shared pixels */
+    if (a.w <= 0 || a.h <= 0 || b.w <= 0 || b.h <= 0)
+      return false;
+    return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+  }
+  INTERN bool
+  draw_batch_compatible(const struct draw_command* a, const struct draw_command* b) {
+    /* instances are grouped while converting already */
+    if (a->instance_count || b->instance_count)
+      return false;
+    return a->texture.id == b->texture.id && a->vertex_offset == b->vertex_offset &&
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+           a->userdata.id == b->userdata.id &&
+#endif
+           a->clip_rect.x == b->clip_rect.x && a->clip_rect.y == b->clip_rect.y &&
+           a->clip_rect.w == b->clip_rect.w && a->clip_rect.h == b->clip_rect.h;
+  }
+  NK_API void
+  draw_list_batch(struct draw_batch* batch, struct draw_list* list) {
+    NK_ASSERT(batch);
+    NK_ASSERT(list);
+    if (!batch || !list)
+      return;
+    const unsigned int count = list->cmd_count;
+    batch->commands_before = count;
+    batch->commands_after = count;
+    if (!count)
+      return;
+
+    struct draw_command* first = ptr_add(struct draw_command, buffer_memory(list->buffer),
+                                         buffer_total(list->buffer) - list->cmd_offset);
+    unsigned int total = 0;
+    for (unsigned int i = 0; i < count; ++i)
+      total += (first - i)->elem_count;
+
+    /* groups, element starts, member links and reordered elements in one block */
+    const std::size_t groups_size = sizeof(struct draw_batch_group) * count;
+    const std::size_t starts_size = sizeof(unsigned int) * count;
+    const std::size_t links_size = sizeof(unsigned int) * count;
+    buffer_clear(&batch->scratch);
+    std::uint8_t* memory = (std::uint8_t*) buffer_alloc(&batch->scratch, buffer_allocation_type::BUFFER_FRONT,
+                                                        groups_size + starts_size + links_size + sizeof(draw_index) * total,
+                                                        alignof(struct draw_batch_group));
+    if (!memory)
+      return;
+    struct draw_batch_group* groups = (struct draw_batch_group*) memory;
+    unsigned int* starts = (unsigned int*) (memory + groups_size);
+    unsigned int* links = (unsigned int*) (memory + groups_size + starts_size);
+    draw_index* sorted = (draw_index*) (memory + groups_size + starts_size + links_size);
+
+    draw_index* elements = (draw_index*) buffer_memory(list->elements);
+    std::size_t position = 0;
+    const bool has_position = draw_batch_position(list, &position);
+    unsigned int group_count = 0;
+    unsigned int start = 0;
+    for (unsigned int i = 0; i < count; ++i) {
+      const struct draw_command* cmd = first - i;
+      starts[i] = start;
+      links[i] = count;
+      start += cmd->elem_count;
+      if (!cmd->elem_count && !cmd->instance_count)
+        continue;
+
+      /* a command may only move in front of groups it does not overlap */
+      const rectf bounds = draw_batch_bounds(list, cmd, elements + starts[i], has_position, position);
+      const unsigned int stop = group_count > NK_DRAW_BATCH_LOOKBACK ? group_count - NK_DRAW_BATCH_LOOKBACK : 0;
+      unsigned int target = count;
+      for (unsigned int g = group_count; g > stop; --g) {
+        if (draw_batch_compatible(&groups[g - 1].cmd, cmd)) {
+          target = g - 1;
+          break;
+        }
+        if (draw_batch_overlaps(groups[g - 1].bounds, bounds))
+          break;
+      }
+      if (target == count) {
+        struct draw_batch_group* g = &groups[group_count++];
+        g->cmd = *cmd;
+        g->bounds = bounds;
+        g->first = g->last = i;
+      } else {
+        struct draw_batch_group* g = &groups[target];
+        g->cmd.elem_count += cmd->elem_count;
+        if (g->bounds.w <= 0 || g->bounds.h <= 0) {
+          g->bounds = bounds;
+        } else if (bounds.w > 0 && bounds.h > 0) {
+          const float x0 = std::min(g->bounds.x, bounds.x), y0 = std::min(g->bounds.y, bounds.y);
+          const float x1 = std::max(g->bounds.x + g->bounds.w, bounds.x + bounds.w);
+          const float y1 = std::max(g->bounds.y + g->bounds.h, bounds.y + bounds.h);
+          g->bounds = rect(x0, y0, x1 - x0, y1 - y0);
+        }
+        links[g->last] = i;
+        g->last = i;
+      }
+    }
+    batch->commands_after = group_count;
+    if (group_count == count)
+      return;
+
+    /* write the elements in group order, members keep their relative order */
+    draw_index* out = sorted;
+    for (unsigned int g = 0; g < group_count; ++g) {
+      for (unsigned int i = groups[g].first; i < count; i = links[i]) {
+        const unsigned int n = (first - i)->elem_count;
+        std::memcpy(out, elements + starts[i], sizeof(draw_index) * n);
+        out += n;
+      }
+    }
+    std::memcpy(elements, sorted, sizeof(draw_index) * total);
+    for (unsigned int g = 0; g < group_count; ++g)
+      *(first - g) = groups[g].cmd;
+
+    /* release the now unused draw commands at the low end of the back buffer */
+    const std::size_t released = sizeof(struct draw_command) * (count - group_count);
+    list->buffer->size += released;
+    list->buffer->needed -= released;
+    list->cmd_count = group_count;
+    list->vertex_base = groups[group_count - 1].cmd.vertex_offset;
+  }
   NK_API flag
   convert(struct context* ctx, memory_buffer* cmds,
           memory_buffer* vertices, memory_buffer* elements,
           const struct convert_config* config) {
+    return convert_writers(ctx, cmds, vertices, elements, config, 0, 0);
+  }
+  NK_API flag
+  convert_with_writer(struct context* ctx, memory_buffer* cmds,
+                      memory_buffer* vertices, memory_buffer* elements,
+                      const struct convert_config* config, draw_vertex_writer writer) {
+    return convert_writers(ctx, cmds, vertices, elements, config, writer, 0);
+  }
+  NK_API flag
+  convert_with_block_writer(struct context* ctx, memory_buffer* cmds,
+                            memory_buffer* vertices, memory_buffer* elements,
+                            const struct convert_config* config, draw_vertex_block_writer writer) {
+    return convert_writers(ctx, cmds, vertices, elements, config, 0, writer);
+  }
+  INTERN flag
+  convert_writers(struct context* ctx, memory_buffer* cmds,
+                  memory_buffer* vertices, memory_buffer* elements, const struct convert_config* config,
+                  draw_vertex_writer writer, draw_vertex_block_writer block_writer) {
     flag res = NK_CONVERT_SUCCESS;
     const struct command* cmd;
     NK_ASSERT(ctx);
@@ -1269,125 +2303,641 @@ namespace nk {
 
     draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
                     config->line_AA, config->shape_AA);
-    foreach (cmd, ctx) {
+    if (writer) {
+      ctx->draw_list.vertex_writer = writer;
+      ctx->draw_list.block_writer = draw_vertex_user;
+    }
+    if (block_writer)
+      ctx->draw_list.block_writer = block_writer;
+    if (config->cache) {
+      convert_cached(ctx, config->cache, config);
+    } else {
+      foreach (cmd, ctx)
+        convert_command(&ctx->draw_list, cmd, config);
+    }
+    res |= convert_result(cmds, vertices, elements);
+    if (config->batch && res == NK_CONVERT_SUCCESS)
+      draw_list_batch(config->batch, &ctx->draw_list);
+    return res;
+  }
+  NK_API flag
+  convert_instanced(struct context* ctx, memory_buffer* cmds, memory_buffer* vertices,
+                    memory_buffer* elements, memory_buffer* instances, const struct convert_config* config) {
+    const struct command* cmd;
+    NK_ASSERT(ctx);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(instances);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    NK_ASSERT(config->vertex_size);
+    if (!ctx || !cmds || !vertices || !elements || !instances || !config || !config->vertex_layout)
+      return NK_CONVERT_INVALID_PARAM;
+
+    /* the vertex cache only knows triangles so every window is converted */
+    draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
+                    config->line_AA, config->shape_AA);
+    ctx->draw_list.instances = instances;
+    foreach (cmd, ctx)
+      convert_command(&ctx->draw_list, cmd, config);
+    flag res = convert_result(cmds, vertices, elements);
+    res |= (instances->needed > instances->allocated) ? NK_CONVERT_INSTANCE_BUFFER_FULL : 0;
+    if (config->batch && res == NK_CONVERT_SUCCESS)
+      draw_list_batch(config->batch, &ctx->draw_list);
+    return res;
+  }
+  NK_API flag
+  convert_replay(struct draw_list* list, const memory_buffer* replay, memory_buffer* cmds,
+                 memory_buffer* vertices, memory_buffer* elements, const struct convert_config* config) {
+    NK_ASSERT(list);
+    NK_ASSERT(replay);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    if (!list || !replay || !cmds || !vertices || !elements || !config || !config->vertex_layout)
+      return NK_CONVERT_INVALID_PARAM;
+
+    draw_list_setup(list, config, cmds, vertices, elements, config->line_AA, config->shape_AA);
+    const std::uint8_t* memory = (const std::uint8_t*) buffer_memory_const(replay);
+    std::size_t offset = 0;
+    while (offset < replay->allocated) {
+      const struct command* cmd = ptr_add_const(struct command, memory, offset);
+      convert_command(list, cmd, config);
+      if (cmd->next <= offset)
+        break;
+      offset = cmd->next;
+    }
+    const flag res = convert_result(cmds, vertices, elements);
+    if (config->batch && res == NK_CONVERT_SUCCESS)
+      draw_list_batch(config->batch, list);
+    return res;
+  }
+  struct convert_buffer_mark {
+    std::size_t allocated;
+    std::size_t needed;
+    std::size_t calls;
+    std::size_t back; /**!< bytes allocated from the back, growing moves that region to the new end */
+  };
+  struct convert_mark {
+    struct draw_list list;
+    struct draw_command last;
+    struct convert_buffer_mark buffers[3];
+  };
+  INTERN void
+  convert_buffer_save(struct convert_buffer_mark* mark, const memory_buffer* b) {
+    /* only counters, the memory itself may have moved in a dynamic buffer */
+    mark->allocated = b->allocated;
+    mark->needed = b->needed;
+    mark->calls = b->calls;
+    mark->back = b->memory.size - b->size;
+  }
+  INTERN void
+  convert_buffer_restore(memory_buffer* b, const struct convert_buffer_mark* mark) {
+    b->allocated = mark->allocated;
+    b->needed = mark->needed;
+    b->calls = mark->calls;
+    b->size = b->memory.size - mark->back;
+  }
+  INTERN void
+  convert_mark_save(struct convert_mark* mark, struct draw_list* list) {
+    mark->list = *list;
+    if (list->cmd_count)
+      mark->last = *draw_list_command_last(list);
+    convert_buffer_save(&mark->buffers[0], list->buffer);
+    convert_buffer_save(&mark->buffers[1], list->vertices);
+    convert_buffer_save(&mark->buffers[2], list->elements);
+  }
+  INTERN void
+  convert_mark_restore(struct draw_list* list, const struct convert_mark* mark) {
+    /* clipping and images may have changed the last command in place */
+    *list = mark->list;
+    convert_buffer_restore(list->buffer, &mark->buffers[0]);
+    convert_buffer_restore(list->vertices, &mark->buffers[1]);
+    convert_buffer_restore(list->elements, &mark->buffers[2]);
+    if (list->cmd_count)
+      *draw_list_command_last(list) = mark->last;
+  }
+  NK_API void
+  convert_stream_begin(struct convert_stream* stream) {
+    NK_ASSERT(stream);
+    if (!stream)
+      return;
+    zero_struct(*stream);
+  }
+  NK_API flag
+  convert_stream_next(struct context* ctx, struct convert_stream* stream,
+                      memory_buffer* cmds, memory_buffer* vertices, memory_buffer* elements,
+                      const struct convert_config* config) {
+    struct draw_list* list = &ctx->draw_list;
+    struct convert_mark mark;
+    const struct command* cmd;
+    bool empty = true;
+
+    NK_ASSERT(ctx);
+    NK_ASSERT(stream);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    if (!ctx || !stream || !cmds || !vertices || !elements || !config || !config->vertex_layout)
+      return NK_CONVERT_INVALID_PARAM;
+    if (stream->done)
+      return NK_CONVERT_SUCCESS;
+
+    draw_list_setup(list, config, cmds, vertices, elements, config->line_AA, config->shape_AA);
+    if (stream->chunks) {
+      /* continue with the draw state the previous chunk ended with */
+      struct draw_command* seed;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+      list->userdata = stream->userdata;
+#endif
+      seed = draw_list_push_command(list, stream->clip_rect, stream->texture);
+      if (!seed)
+        return convert_result(cmds, vertices, elements);
+      cmd = ptr_add_const(struct command, ctx->memory.memory.ptr, stream->offset);
+    } else {
+      cmd = _begin(ctx);
+    }
+    for (; cmd; cmd = _next(ctx, cmd)) {
+      convert_mark_save(&mark, list);
+      convert_command(list, cmd, config);
+      const flag res = convert_result(cmds, vertices, elements);
+      if (!res) {
+        empty = false;
+        continue;
+      }
+      /* drop the partial output of this command and start the next chunk with it */
+      convert_mark_restore(list, &mark);
+      if (empty)
+        return res;
+      stream->offset = (std::size_t) ((const std::uint8_t*) cmd - (const std::uint8_t*) ctx->memory.memory.ptr);
+      stream->clip_rect = list->clip_rect;
+      stream->texture = list->cmd_count ? draw_list_command_last(list)->texture : config->tex_null.texture;
 #ifdef NK_INCLUDE_COMMAND_USERDATA
-      ctx->draw_list.userdata = cmd->userdata;
+      stream->userdata = list->userdata;
 #endif
+      stream->chunks++;
+      return NK_CONVERT_SUCCESS;
+    }
+    stream->chunks++;
+    stream->done = true;
+    return NK_CONVERT_SUCCESS;
+  }
+  NK_API flag
+  convert_stream(struct context* ctx, memory_buffer* cmds, memory_buffer* vertices,
+                 memory_buffer* elements, const struct convert_config* config,
+                 convert_flush_f flush, resource_handle userdata) {
+    struct convert_stream stream;
+    NK_ASSERT(flush);
+    if (!flush)
+      return NK_CONVERT_INVALID_PARAM;
+
+    convert_stream_begin(&stream);
+    while (!stream.done) {
+      buffer_clear(cmds);
+      buffer_clear(vertices);
+      buffer_clear(elements);
+      const flag res = convert_stream_next(ctx, &stream, cmds, vertices, elements, config);
+      if (res)
+        return res;
+      flush(userdata, &ctx->draw_list, cmds, vertices, elements);
+    }
+    return NK_CONVERT_SUCCESS;
+  }
+  /** threads of `convert_workers` without a user dispatcher. They are started
+   * once and park between frames instead of being created per conversion */
+  struct convert_pool {
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::thread threads[NK_CONVERT_MAX_WORKERS];
+    convert_task_f task = nullptr;
+    void* data = nullptr;
+    int count = 0; /**!< workers taking part in the current generation */
+    int pending = 0; /**!< pool threads still running the current task */
+    unsigned int generation = 0;
+    bool stop = false;
+  };
+  INTERN void
+  convert_pool_run(struct convert_pool* pool, const int index) {
+    unsigned int seen = 0;
+    for (;;) {
+      convert_task_f task;
+      void* data;
+      {
+        std::unique_lock<std::mutex> guard(pool->lock);
+        pool->wake.wait(guard, [&] { return pool->stop || pool->generation != seen; });
+        if (pool->stop)
+          return;
+        seen = pool->generation;
+        if (index >= pool->count)
+          continue;
+        task = pool->task;
+        data = pool->data;
+      }
+      task(data, index);
+      std::lock_guard<std::mutex> guard(pool->lock);
+      if (--pool->pending == 0)
+        pool->done.notify_one();
+    }
+  }
+  INTERN void
+  convert_pool_dispatch(struct convert_pool* pool, const convert_task_f task, void* data, const int count) {
+    {
+      std::lock_guard<std::mutex> guard(pool->lock);
+      pool->task = task;
+      pool->data = data;
+      pool->count = count;
+      pool->pending = count - 1;
+      pool->generation++;
+    }
+    pool->wake.notify_all();
+    task(data, 0);
+    std::unique_lock<std::mutex> guard(pool->lock);
+    pool->done.wait(guard, [&] { return pool->pending == 0; });
+  }
+  NK_API void
+  convert_workers_init(struct convert_workers* workers, const struct allocator* alloc,
+                       const int count, const plugin_dispatch dispatch, const resource_handle userdata) {
+    NK_ASSERT(workers);
+    NK_ASSERT(alloc);
+    NK_ASSERT(count > 0);
+    if (!workers || !alloc || count <= 0)
+      return;
+    zero_struct(*workers);
+    workers->alloc = *alloc;
+    workers->dispatch = dispatch;
+    workers->userdata = userdata;
+    workers->count = std::min(count, NK_CONVERT_MAX_WORKERS);
+    buffer_init(&workers->segments, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    for (int i = 0; i < workers->count; ++i) {
+      struct convert_worker* w = &workers->worker[i];
+      draw_list_init(&w->list);
+      buffer_init(&w->cmds, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      buffer_init(&w->vertices, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      buffer_init(&w->elements, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    }
+    if (dispatch || workers->count <= 1)
+      return;
+    void* memory = alloc->alloc(alloc->userdata, 0, sizeof(struct convert_pool));
+    if (!memory)
+      return;
+    workers->pool = new (memory) convert_pool();
+    for (int i = 1; i < workers->count; ++i)
+      workers->pool->threads[i] = std::thread(convert_pool_run, workers->pool, i);
+  }
+  NK_API void
+  convert_workers_free(struct convert_workers* workers) {
+    NK_ASSERT(workers);
+    if (!workers)
+      return;
+    if (workers->pool) {
+      {
+        std::lock_guard<std::mutex> guard(workers->pool->lock);
+        workers->pool->stop = true;
+      }
+      workers->pool->wake.notify_all();
+      for (int i = 1; i < workers->count; ++i)
+        workers->pool->threads[i].join();
+      workers->pool->~convert_pool();
+      workers->alloc.free(workers->alloc.userdata, workers->pool);
+    }
+    buffer_free(&workers->segments);
+    for (int i = 0; i < workers->count; ++i) {
+      buffer_free(&workers->worker[i].cmds);
+      buffer_free(&workers->worker[i].vertices);
+      buffer_free(&workers->worker[i].elements);
+    }
+    zero_struct(*workers);
+  }
+  INTERN bool
+  convert_predict_state(const struct context* ctx, const struct convert_segment* seg,
+                        const struct convert_config* config, struct draw_command* state, bool* has_elements) {
+    /* guesses the last vertex draw command a segment leaves behind from its
+     * commands alone. Culled primitives can make this wrong, which is caught
+     * when joining the worker output. */
+    const std::uint8_t* memory = (const std::uint8_t*) ctx->memory.memory.ptr;
+    bool clipped = false;
+    std::size_t offset = seg->begin;
+    zero(state, sizeof(*state));
+    state->clip_rect = null_rect;
+    state->texture = config->tex_null.texture;
+    *has_elements = false;
+    while (1) {
+      const struct command* cmd = ptr_add_const(struct command, memory, offset);
       switch (cmd->type) {
         case command_type::COMMAND_NOP:
           break;
         case command_type::COMMAND_SCISSOR: {
-          const struct command_scissor* s = (const struct command_scissor*) cmd;
-          draw_list_add_clip(&ctx->draw_list, rect(s->x, s->y, s->w, s->h));
-        } break;
-        case command_type::COMMAND_LINE: {
-          const struct command_line* l = (const struct command_line*) cmd;
-          draw_list_stroke_line(&ctx->draw_list, vec2_from_floats(l->begin.x, l->begin.y),
-                                vec2_from_floats(l->end.x, l->end.y), l->color, l->line_thickness);
-        } break;
-        case command_type::COMMAND_CURVE: {
-          const struct command_curve* q = (const struct command_curve*) cmd;
-          draw_list_stroke_curve(&ctx->draw_list, vec2_from_floats(q->begin.x, q->begin.y),
-                                 vec2_from_floats(q->ctrl[0].x, q->ctrl[0].y), vec2_from_floats(q->ctrl[1].x, q->ctrl[1].y), vec2_from_floats(q->end.x, q->end.y), q->color,
-                                 config->curve_segment_count, q->line_thickness);
-        } break;
-        case command_type::COMMAND_RECT: {
-          const struct command_rect* r = (const struct command_rect*) cmd;
-          draw_list_stroke_rect(&ctx->draw_list, rect(r->x, r->y, r->w, r->h),
-                                r->color, (float) r->rounding, r->line_thickness);
-        } break;
-        case command_type::COMMAND_RECT_FILLED: {
-          const struct command_rect_filled* r = (const struct command_rect_filled*) cmd;
-          draw_list_fill_rect(&ctx->draw_list, rect(r->x, r->y, r->w, r->h),
-                              r->color, (float) r->rounding);
-        } break;
-        case command_type::COMMAND_RECT_MULTI_COLOR: {
-          const struct command_rect_multi_color* r = (const struct command_rect_multi_color*) cmd;
-          draw_list_fill_rect_multi_color(&ctx->draw_list, rect(r->x, r->y, r->w, r->h),
-                                          r->left, r->top, r->right, r->bottom);
-        } break;
-        case command_type::COMMAND_CIRCLE: {
-          const struct command_circle* c = (const struct command_circle*) cmd;
-          draw_list_stroke_circle(&ctx->draw_list, vec2_from_floats((float) c->x + (float) c->w / 2, (float) c->y + (float) c->h / 2), (float) c->w / 2, c->color,
-                                  config->circle_segment_count, c->line_thickness);
-        } break;
-        case command_type::COMMAND_CIRCLE_FILLED: {
-          const struct command_circle_filled* c = (const struct command_circle_filled*) cmd;
-          draw_list_fill_circle(&ctx->draw_list, vec2_from_floats((float) c->x + (float) c->w / 2, (float) c->y + (float) c->h / 2), (float) c->w / 2, c->color,
-                                config->circle_segment_count);
-        } break;
-        case command_type::COMMAND_ARC: {
-          const struct command_arc* c = (const struct command_arc*) cmd;
-          draw_list_path_line_to(&ctx->draw_list, vec2_from_floats(c->cx, c->cy));
-          draw_list_path_arc_to(&ctx->draw_list, vec2_from_floats(c->cx, c->cy), c->r,
-                                c->a[0], c->a[1], config->arc_segment_count);
-          draw_list_path_stroke(&ctx->draw_list, c->color, NK_STROKE_CLOSED, c->line_thickness);
-        } break;
-        case command_type::COMMAND_ARC_FILLED: {
-          const struct command_arc_filled* c = (const struct command_arc_filled*) cmd;
-          draw_list_path_line_to(&ctx->draw_list, vec2_from_floats(c->cx, c->cy));
-          draw_list_path_arc_to(&ctx->draw_list, vec2_from_floats(c->cx, c->cy), c->r,
-                                c->a[0], c->a[1], config->arc_segment_count);
-          draw_list_path_fill(&ctx->draw_list, c->color);
-        } break;
-        case command_type::COMMAND_TRIANGLE: {
-          const struct command_triangle* t = (const struct command_triangle*) cmd;
-          draw_list_stroke_triangle(&ctx->draw_list, vec2_from_floats(t->a.x, t->a.y),
-                                    vec2_from_floats(t->b.x, t->b.y), vec2_from_floats(t->c.x, t->c.y), t->color,
-                                    t->line_thickness);
-        } break;
-        case command_type::COMMAND_TRIANGLE_FILLED: {
-          const struct command_triangle_filled* t = (const struct command_triangle_filled*) cmd;
-          draw_list_fill_triangle(&ctx->draw_list, vec2_from_floats(t->a.x, t->a.y),
-                                  vec2_from_floats(t->b.x, t->b.y), vec2_from_floats(t->c.x, t->c.y), t->color);
-        } break;
-        case command_type::COMMAND_POLYGON: {
-          int i;
-          const struct command_polygon* p = (const struct command_polygon*) cmd;
-          for (i = 0; i < p->point_count; ++i) {
-            vec2f pnt = vec2_from_floats((float) p->points[i].x, (float) p->points[i].y);
-            draw_list_path_line_to(&ctx->draw_list, pnt);
-          }
-          draw_list_path_stroke(&ctx->draw_list, p->color, NK_STROKE_CLOSED, p->line_thickness);
-        } break;
-        case command_type::COMMAND_POLYGON_FILLED: {
-          int i;
-          const struct command_polygon_filled* p = (const struct command_polygon_filled*) cmd;
-          for (i = 0; i < p->point_count; ++i) {
-            vec2f pnt = vec2_from_floats((float) p->points[i].x, (float) p->points[i].y);
-            draw_list_path_line_to(&ctx->draw_list, pnt);
-          }
-          draw_list_path_fill(&ctx->draw_list, p->color);
-        } break;
-        case command_type::COMMAND_POLYLINE: {
-          int i;
-          const struct command_polyline* p = (const struct command_polyline*) cmd;
-          for (i = 0; i < p->point_count; ++i) {
-            vec2f pnt = vec2_from_floats((float) p->points[i].x, (float) p->points[i].y);
-            draw_list_path_line_to(&ctx->draw_list, pnt);
-          }
-          draw_list_path_stroke(&ctx->draw_list, p->color, NK_STROKE_OPEN, p->line_thickness);
-        } break;
-        case command_type::COMMAND_TEXT: {
-          const struct command_text* t = (const struct command_text*) cmd;
-          draw_list_add_text(&ctx->draw_list, t->font, rect(t->x, t->y, t->w, t->h),
-                             t->string, t->length, t->height, t->foreground);
-        } break;
-        case command_type::COMMAND_IMAGE: {
-          const struct command_image* i = (const struct command_image*) cmd;
-          draw_list_add_image(&ctx->draw_list, i->img, rect(i->x, i->y, i->w, i->h), i->col);
-        } break;
-        case command_type::COMMAND_CUSTOM: {
-          const struct command_custom* c = (const struct command_custom*) cmd;
-          c->callback(&ctx->draw_list, c->x, c->y, c->w, c->h, c->callback_data);
+          const struct command_scissor* sc = (const struct command_scissor*) cmd;
+          state->clip_rect = rect(sc->x, sc->y, sc->w, sc->h);
+          *has_elements = false;
+          clipped = true;
         } break;
+        case command_type::COMMAND_TEXT:
+          state->texture = ((const struct command_text*) cmd)->font->texture;
+          *has_elements = true;
+          break;
+        case command_type::COMMAND_IMAGE:
+          state->texture = ((const struct command_image*) cmd)->img.handle;
+          *has_elements = true;
+          break;
+        case command_type::COMMAND_CUSTOM:
+          return false;
         default:
+          state->texture = config->tex_null.texture;
+          *has_elements = true;
           break;
       }
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+      state->userdata = cmd->userdata;
+#endif
+      if (offset == seg->last || cmd->next <= offset || cmd->next >= ctx->memory.allocated)
+        break;
+      offset = cmd->next;
     }
-    res |= (cmds->needed > cmds->allocated + (cmds->memory.size - cmds->size)) ? NK_CONVERT_COMMAND_BUFFER_FULL : 0;
-    res |= (vertices->needed > vertices->allocated) ? NK_CONVERT_VERTEX_BUFFER_FULL : 0;
-    res |= (elements->needed > elements->allocated) ? NK_CONVERT_ELEMENT_BUFFER_FULL : 0;
+    return clipped;
+  }
+  INTERN bool
+  convert_state_matches(const struct draw_list* list, const struct convert_worker* w) {
+    if (!list->cmd_count)
+      return false;
+    const struct draw_command* prev = draw_list_command_last((struct draw_list*) list);
+    return std::memcmp(&prev->clip_rect, &w->seed.clip_rect, sizeof(prev->clip_rect)) == 0 &&
+           std::memcmp(&prev->texture, &w->seed.texture, sizeof(prev->texture)) == 0 &&
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+           std::memcmp(&prev->userdata, &w->seed.userdata, sizeof(prev->userdata)) == 0 &&
+#endif
+           (prev->elem_count != 0) == w->seed_elements;
+  }
+  struct convert_job {
+    const struct context* ctx;
+    struct convert_workers* workers;
+    const struct convert_segment* segments;
+    const struct convert_config* config;
+  };
+  INTERN void
+  convert_worker_run(void* data, const int index) {
+    const struct convert_job* job = (const struct convert_job*) data;
+    struct convert_worker* w = &job->workers->worker[index];
+    w->valid = false;
+    if (!w->count)
+      return;
+
+    buffer_clear(&w->cmds);
+    buffer_clear(&w->vertices);
+    buffer_clear(&w->elements);
+    draw_list_setup(&w->list, job->config, &w->cmds, &w->vertices, &w->elements,
+                    job->config->line_AA, job->config->shape_AA);
+    w->list.arcs = &w->arcs;
+    if (w->first) {
+      /* continue from the predicted state of the previous segment */
+      if (!convert_predict_state(job->ctx, &job->segments[w->first - 1], job->config, &w->seed, &w->seed_elements))
+        return;
+      struct draw_command* seed = draw_list_push_command(&w->list, w->seed.clip_rect, w->seed.texture);
+      if (!seed)
+        return;
+      seed->elem_count = w->seed_elements ? 1 : 0;
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+      seed->userdata = w->seed.userdata;
+#endif
+    }
+    for (unsigned int i = w->first; i < w->first + w->count; ++i)
+      convert_segment(job->ctx, &w->list, job->segments[i].begin, job->segments[i].last, job->config);
+    w->valid = !convert_result(&w->cmds, &w->vertices, &w->elements);
+  }
+  INTERN void
+  convert_worker_join(struct draw_list* list, const struct convert_worker* w) {
+    const unsigned int first = list->vertex_count;
+    const bool rebase = draw_list_needs_rebase(list, w->list.vertex_count);
+    draw_index* ids = 0;
+    if (w->list.vertex_count) {
+      void* vtx = draw_list_alloc_vertices(list, w->list.vertex_count);
+      if (vtx)
+        std::memcpy(vtx, buffer_memory_const(&w->vertices), list->config.vertex_size * w->list.vertex_count);
+    }
+    if (w->list.element_count) {
+      ids = (draw_index*) buffer_alloc(list->elements, buffer_allocation_type::BUFFER_FRONT,
+                                       sizeof(draw_index) * w->list.element_count, alignof(draw_index));
+      if (ids)
+        list->element_count += w->list.element_count;
+    }
+    const draw_index* src_ids = (const draw_index*) buffer_memory_const(&w->elements);
+    const struct draw_command* cmd = _draw_list_begin(&w->list, &w->cmds);
+    for (bool seed = w->first != 0; cmd; cmd = _draw_list_next(cmd, &w->cmds, &w->list), seed = false) {
+      struct draw_command* dst;
+      unsigned int elem_count = cmd->elem_count;
+      if (rebase)
+        list->vertex_base = cmd->vertex_offset + first;
+      if (seed && !rebase) {
+        /* seed command stands for the last command of the previous worker */
+        elem_count -= w->seed_elements ? 1 : 0;
+        dst = draw_list_command_last(list);
+        dst->clip_rect = cmd->clip_rect;
+        dst->texture = cmd->texture;
+        dst->elem_count += elem_count;
+        list->clip_rect = cmd->clip_rect;
+      } else {
+        /* a rebased seed can not be merged and becomes a command of its own */
+        if (seed)
+          elem_count -= w->seed_elements ? 1 : 0;
+        dst = draw_list_push_command(list, cmd->clip_rect, cmd->texture);
+        if (!dst)
+          break;
+        dst->elem_count = elem_count;
+      }
+#ifdef NK_INCLUDE_COMMAND_USERDATA
+      dst->userdata = cmd->userdata;
+#endif
+      if (ids) {
+        draw_list_copy_elements(ids, src_ids, elem_count, cmd->vertex_offset + first - list->vertex_base);
+        ids += elem_count;
+      }
+      src_ids += elem_count;
+    }
+  }
+  INTERN bool
+  convert_add_segment(memory_buffer* segments, const std::size_t begin, const std::size_t last, const std::size_t end) {
+    struct convert_segment* seg = (struct convert_segment*) buffer_alloc(segments, buffer_allocation_type::BUFFER_FRONT,
+                                                                         sizeof(struct convert_segment), alignof(struct convert_segment));
+    if (!seg)
+      return false;
+    seg->begin = begin;
+    seg->last = last;
+    seg->size = end - begin;
+    return true;
+  }
+  NK_API flag
+  convert_parallel(struct context* ctx, struct convert_workers* workers, memory_buffer* cmds,
+                   memory_buffer* vertices, memory_buffer* elements, const struct convert_config* config) {
+    NK_ASSERT(ctx);
+    NK_ASSERT(workers);
+    NK_ASSERT(cmds);
+    NK_ASSERT(vertices);
+    NK_ASSERT(elements);
+    NK_ASSERT(config);
+    NK_ASSERT(config->vertex_layout);
+    NK_ASSERT(config->vertex_size);
+    if (!ctx || !workers || !cmds || !vertices || !elements || !config || !config->vertex_layout)
+      return NK_CONVERT_INVALID_PARAM;
+    if (config->cache || workers->count <= 1)
+      return convert(ctx, cmds, vertices, elements, config);
+
+    draw_list_setup(&ctx->draw_list, config, cmds, vertices, elements,
+                    config->line_AA, config->shape_AA);
+    const struct command* cmd = _begin(ctx);
+    if (!cmd)
+      return NK_CONVERT_SUCCESS;
+
+    /* split the command list into one segment per window, per popup and for the overlay
+     * in the order `build` linked them, popup memory may lie before its predecessor */
+    buffer_clear(&workers->segments);
+    unsigned int segment_count = 0;
+    std::size_t total = 0;
+    for (const window* it = ctx->begin; it; it = it->next) {
+      if (it->buffer.last == it->buffer.begin || (it->flags & static_cast<decltype(it->flags)>(window_flags::WINDOW_HIDDEN)) ||
+          it->seq != ctx->seq)
+        continue;
+      if (!convert_add_segment(&workers->segments, it->buffer.begin, it->buffer.last, it->buffer.end))
+        return convert(ctx, cmds, vertices, elements, config);
+      total += it->buffer.end - it->buffer.begin;
+      segment_count++;
+    }
+    for (const window* it = ctx->begin; it; it = it->next) {
+      if (!it->popup.buf.linked)
+        continue;
+      if (!convert_add_segment(&workers->segments, it->popup.buf.begin, it->popup.buf.last, it->popup.buf.end))
+        return convert(ctx, cmds, vertices, elements, config);
+      total += it->popup.buf.end - it->popup.buf.begin;
+      segment_count++;
+    }
+    if (ctx->overlay.end != ctx->overlay.begin) {
+      if (!convert_add_segment(&workers->segments, ctx->overlay.begin, ctx->overlay.last, ctx->overlay.end))
+        return convert(ctx, cmds, vertices, elements, config);
+      total += ctx->overlay.end - ctx->overlay.begin;
+      segment_count++;
+    }
+    const struct convert_segment* segments = (const struct convert_segment*) buffer_memory_const(&workers->segments);
+
+    /* hand out contiguous runs of segments with about the same command size */
+    int count = std::min(workers->count, (int) segment_count);
+    const std::size_t share = total / (std::size_t) std::max(count, 1) + 1;
+    std::size_t filled = 0;
+    int w = 0;
+    for (int i = 0; i < workers->count; ++i) {
+      workers->worker[i].first = 0;
+      workers->worker[i].count = 0;
+    }
+    for (unsigned int i = 0; i < segment_count; ++i) {
+      workers->worker[w].count++;
+      filled += segments[i].size;
+      if (filled >= share * (std::size_t) (w + 1) && w + 1 < count && i + 1 < segment_count) {
+        w++;
+        workers->worker[w].first = i + 1;
+      }
+    }
+    count = w + 1;
+
+    struct convert_job job;
+    job.ctx = ctx;
+    job.workers = workers;
+    job.segments = segments;
+    job.config = config;
+    if (workers->dispatch)
+      workers->dispatch(workers->userdata, convert_worker_run, &job, count);
+    else if (workers->pool)
+      convert_pool_dispatch(workers->pool, convert_worker_run, &job, count);
+    else
+      for (int i = 0; i < count; ++i)
+        convert_worker_run(&job, i);
+
+    /* join worker output and redo workers which started from a wrong state */
+    for (int i = 0; i < count; ++i) {
+      const struct convert_worker* wk = &workers->worker[i];
+      if (wk->valid && (!wk->first || convert_state_matches(&ctx->draw_list, wk))) {
+        convert_worker_join(&ctx->draw_list, wk);
+      } else {
+        for (unsigned int j = wk->first; j < wk->first + wk->count; ++j)
+          convert_segment(ctx, &ctx->draw_list, segments[j].begin, segments[j].last, config);
+      }
+    }
+    const flag res = convert_result(cmds, vertices, elements);
+    if (config->batch && res == NK_CONVERT_SUCCESS)
+      draw_list_batch(config->batch, &ctx->draw_list);
+    return res;
+  }
+  NK_API void
+  convert_planner_init(struct convert_planner* planner, const struct allocator* alloc) {
+    NK_ASSERT(planner);
+    NK_ASSERT(alloc);
+    if (!planner || !alloc)
+      return;
+    zero_struct(*planner);
+    buffer_init(&planner->commands, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    buffer_init(&planner->vertices, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    buffer_init(&planner->elements, alloc, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  }
+  NK_API void
+  convert_planner_reset(struct convert_planner* planner) {
+    NK_ASSERT(planner);
+    if (!planner)
+      return;
+    zero_struct(planner->envelope);
+    planner->frames = 0;
+  }
+  NK_API void
+  convert_planner_free(struct convert_planner* planner) {
+    NK_ASSERT(planner);
+    if (!planner)
+      return;
+    buffer_free(&planner->commands);
+    buffer_free(&planner->vertices);
+    buffer_free(&planner->elements);
+    zero_struct(*planner);
+  }
+  NK_API flag
+  convert_measure(struct context* ctx, struct convert_planner* planner,
+                  const struct convert_config* config, struct convert_requirements* frame) {
+    NK_ASSERT(ctx);
+    NK_ASSERT(planner);
+    NK_ASSERT(config);
+    if (!ctx || !planner || !config)
+      return NK_CONVERT_INVALID_PARAM;
+
+    /* the cache would be advanced by a conversion into scratch buffers */
+    struct convert_config measure = *config;
+    measure.cache = 0;
+    measure.batch = 0;
+    memory_buffer* buffers[] = {&planner->commands, &planner->vertices, &planner->elements};
+    for (memory_buffer* b : buffers) {
+      buffer_clear(b);
+      b->peak = 0;
+    }
+
+    /* keep the draw list of a previous `convert` valid for iterating its output */
+    const struct draw_list list = ctx->draw_list;
+    const flag res = convert(ctx, &planner->commands, &planner->vertices, &planner->elements, &measure);
+    ctx->draw_list = list;
+
+    struct convert_requirements* req = &planner->frame;
+    req->commands = planner->commands.peak;
+    req->vertices = planner->vertices.peak;
+    req->elements = planner->elements.peak;
+    req->memory = ctx->memory.allocated + (ctx->memory.memory.size - ctx->memory.size);
+    if (frame)
+      *frame = *req;
+    if (res != NK_CONVERT_SUCCESS)
+      return res;
+
+    planner->envelope.commands = std::max(planner->envelope.commands, req->commands);
+    planner->envelope.vertices = std::max(planner->envelope.vertices, req->vertices);
+    planner->envelope.elements = std::max(planner->envelope.elements, req->elements);
+    planner->envelope.memory = std::max(planner->envelope.memory, req->memory);
+    planner->frames++;
     return res;
   }
   NK_API const struct draw_command*
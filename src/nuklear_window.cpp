@@ -7,13 +7,66 @@ namespace nk {
    *                              WINDOW
    *
    * ===============================================================*/
+  NK_STATIC_ASSERT((NK_WINDOW_INDEX_SIZE & (NK_WINDOW_INDEX_SIZE - 1)) == 0);
+#define NK_WINDOW_INDEX_MASK (NK_WINDOW_INDEX_SIZE - 1)
+
+  INTERN bool
+  window_index_contains(const context* ctx, const window* win) {
+    const window_index* index = &ctx->window_index;
+    unsigned int slot = win->name & NK_WINDOW_INDEX_MASK;
+    while (index->slots[slot] != nullptr) {
+      if (index->slots[slot] == win)
+        return true;
+      slot = (slot + 1) & NK_WINDOW_INDEX_MASK;
+    }
+    return false;
+  }
+  INTERN void
+  window_index_insert(context* ctx, window* win) {
+    window_index* index = &ctx->window_index;
+    if (index->count >= (NK_WINDOW_INDEX_SIZE / 4) * 3) {
+      /* keep probe sequences short and fall back to the list for the rest */
+      index->overflow++;
+      return;
+    }
+    unsigned int slot = win->name & NK_WINDOW_INDEX_MASK;
+    while (index->slots[slot] != nullptr)
+      slot = (slot + 1) & NK_WINDOW_INDEX_MASK;
+    index->slots[slot] = win;
+    index->count++;
+  }
+  INTERN bool
+  window_index_remove(context* ctx, const window* win) {
+    window_index* index = &ctx->window_index;
+    unsigned int slot = win->name & NK_WINDOW_INDEX_MASK;
+    while (index->slots[slot] != win) {
+      if (index->slots[slot] == nullptr)
+        return false;
+      slot = (slot + 1) & NK_WINDOW_INDEX_MASK;
+    }
+    /* backward shift deletion: move following entries into the hole as long
+     * as that does not move them in front of their home slot */
+    unsigned int hole = slot;
+    slot = (slot + 1) & NK_WINDOW_INDEX_MASK;
+    while (index->slots[slot] != nullptr) {
+      const unsigned int home = index->slots[slot]->name & NK_WINDOW_INDEX_MASK;
+      if (((slot - home) & NK_WINDOW_INDEX_MASK) >= ((slot - hole) & NK_WINDOW_INDEX_MASK)) {
+        index->slots[hole] = index->slots[slot];
+        hole = slot;
+      }
+      slot = (slot + 1) & NK_WINDOW_INDEX_MASK;
+    }
+    index->slots[hole] = 0;
+    index->count--;
+    return true;
+  }
   NK_LIB void*
   create_window(context* ctx) {
-    page_element* elem = create_page_element(ctx);
-    if (elem == nullptr)
+    window* win = (window*) create_page_element(ctx, page_type::PAGE_WINDOW);
+    if (win == nullptr)
       return 0;
-    elem->data.win.seq = ctx->seq;
-    return &elem->data.win;
+    win->seq = ctx->seq;
+    return win;
   }
   NK_LIB void
   free_window(context* ctx, window* win) {
@@ -23,6 +76,7 @@ namespace nk {
       free_window(ctx, win->popup.win);
       win->popup.win = 0;
     }
+    window_index_remove(ctx, win);
     win->next = 0;
     win->prev = 0;
 
@@ -35,16 +89,27 @@ namespace nk {
         win->tables = n;
       it = n;
     }
+    free_value_index(ctx, win);
 
     /* link windows into freelist */
-    {
-      page_data* pd = NK_CONTAINER_OF(win, union page_data, win);
-      page_element* pe = NK_CONTAINER_OF(pd, struct page_element, data);
-      free_page_element(ctx, pe);
-    }
+    free_page_element(ctx, page_type::PAGE_WINDOW, win);
   }
   NK_LIB window*
   find_window(const context* ctx, const hash hash, const char* name) {
+    const window_index* index = &ctx->window_index;
+    unsigned int slot = hash & NK_WINDOW_INDEX_MASK;
+    while (index->slots[slot] != nullptr) {
+      window* win = index->slots[slot];
+      if (win->name == hash) {
+        const int max_len = strlen(win->name_string);
+        if (stricmpn(win->name_string, name, max_len) == 0)
+          return win;
+      }
+      slot = (slot + 1) & NK_WINDOW_INDEX_MASK;
+    }
+    if (index->overflow == 0)
+      return 0;
+
     window* iter = ctx->begin;
     while (iter != nullptr) {
       NK_ASSERT(iter != iter->next);
@@ -65,14 +130,20 @@ namespace nk {
     if ((win == nullptr) || (ctx == nullptr))
       return;
 
-    const window* iter = ctx->begin;
-    while (iter != nullptr) {
-      NK_ASSERT(iter != iter->next);
-      NK_ASSERT(iter != win);
-      if (iter == win)
-        return;
-      iter = iter->next;
+    NK_ASSERT(!window_index_contains(ctx, win));
+    if (window_index_contains(ctx, win))
+      return;
+    if (ctx->window_index.overflow != 0) {
+      const window* iter = ctx->begin;
+      while (iter != nullptr) {
+        NK_ASSERT(iter != iter->next);
+        NK_ASSERT(iter != win);
+        if (iter == win)
+          return;
+        iter = iter->next;
+      }
     }
+    window_index_insert(ctx, win);
 
     if (ctx->begin == nullptr) {
       win->next = 0;
@@ -125,6 +196,8 @@ namespace nk {
       if (ctx->end)
         ctx->end->flags &= ~static_cast<flag>(window_flags::WINDOW_ROM);
     }
+    if (!window_index_remove(ctx, win) && ctx->window_index.overflow != 0)
+      ctx->window_index.overflow--;
     win->next = 0;
     win->prev = 0;
     ctx->count--;
@@ -160,6 +233,11 @@ namespace nk {
       if (!win)
         return 0;
 
+      /* name has to be set before linking since the window index is keyed by it */
+      win->name = name_hash;
+      name_length = std::min(name_length, NK_WINDOW_MAX_NAME - 1uz);
+      std::memcpy(win->name_string, name, name_length);
+      win->name_string[name_length] = 0;
       if (flags & panel_flags::WINDOW_BACKGROUND)
         insert_window(ctx, win, NK_INSERT_FRONT);
       else
@@ -168,10 +246,6 @@ namespace nk {
 
       win->flags = flags;
       win->bounds = bounds;
-      win->name = name_hash;
-      name_length = std::min(name_length, NK_WINDOW_MAX_NAME - 1uz);
-      std::memcpy(win->name_string, name, name_length);
-      win->name_string[name_length] = 0;
       win->popup.win = 0;
       win->widgets_disabled = true;
       if (!ctx->active)
@@ -510,6 +584,39 @@ namespace nk {
       return 0;
     return win == ctx->active;
   }
+  NK_API bool
+  window_changed(context* ctx, const char* name) {
+    NK_ASSERT(ctx);
+    if (!ctx)
+      return 0;
+
+    const window* win = window_find(ctx, name);
+    if (!win)
+      return 0;
+    if (!ctx->build) {
+      build(ctx);
+      ctx->build = true;
+    }
+    return win->command_modified;
+  }
+  NK_API bool
+  window_memory_info(const context* ctx, const char* name, struct window_memory_stats* stats) {
+    NK_ASSERT(ctx);
+    NK_ASSERT(stats);
+    if (!ctx || !stats)
+      return 0;
+
+    const window* win = window_find(ctx, name);
+    if (!win)
+      return 0;
+    zero_struct(*stats);
+    stats->tables = win->table_count;
+    for (const table* it = win->tables; it; it = it->next)
+      stats->values += it->size;
+    stats->table_bytes = sizeof(table) * win->table_count;
+    stats->index_bytes = sizeof(value_slot) * win->values.capacity;
+    return 1;
+  }
   NK_API window*
   window_find(const context* ctx, const char* name) {
     const int title_len = (int) strlen(name);
@@ -0,0 +1,46 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "scene.hpp"
+
+namespace {
+  constexpr int warmup_frames = 8;
+  constexpr int frames = 64;
+}
+
+TEST_CASE("steady state frames do not allocate", "[allocation]") {
+  const nk::allocator heap = nk_test::heap();
+  nk::allocation_guard guard;
+  nk::allocation_guard_init(&guard, &heap, 0, nk::handle_id(0));
+  const nk::allocator guarded = nk::allocation_guard_allocator(&guard);
+
+  const nk::user_font font = nk_test::font();
+  nk::context ctx;
+  REQUIRE(nk::init(&ctx, &guarded, &font));
+
+  nk::memory_buffer cmds, vertices, elements;
+  nk::buffer_init(&cmds, &guarded, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  nk::buffer_init(&vertices, &guarded, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  nk::buffer_init(&elements, &guarded, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+  const nk::convert_config cfg = nk_test::convert_config();
+
+  nk_test::overview scene;
+  for (int i = 0; i < warmup_frames + frames; ++i) {
+    if (i == warmup_frames)
+      nk::allocation_guard_arm(&guard);
+    nk_test::overview_frame(&ctx, &scene, i);
+    nk::buffer_clear(&cmds);
+    nk::buffer_clear(&vertices);
+    nk::buffer_clear(&elements);
+    REQUIRE(nk::convert<nk::draw_vertex_layout_pos2f_uv2f_rgba8>(&ctx, &cmds, &vertices, &elements, &cfg) == nk::NK_CONVERT_SUCCESS);
+    nk::clear(&ctx);
+  }
+  nk::allocation_guard_disarm(&guard);
+
+  CHECK(guard.allocs == 0);
+  CHECK(guard.frees == 0);
+
+  nk::buffer_free(&cmds);
+  nk::buffer_free(&vertices);
+  nk::buffer_free(&elements);
+  nk::free(&ctx);
+}
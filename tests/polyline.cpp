@@ -0,0 +1,83 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <vector>
+
+#include "scene.hpp"
+
+namespace {
+  struct polyline_list {
+    nk::allocator heap = nk_test::heap();
+    nk::convert_config cfg = nk_test::convert_config();
+    nk::memory_buffer cmds, vertices, elements;
+    nk::draw_list list;
+
+    polyline_list() {
+      nk::buffer_init(&cmds, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      nk::buffer_init(&vertices, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      nk::buffer_init(&elements, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      nk::draw_list_init(&list);
+      nk::draw_list_setup(&list, &cfg, &cmds, &vertices, &elements, cfg.line_AA, cfg.shape_AA);
+      /* polylines append to the last command, the path api pushes the first one */
+      nk::draw_list_path_line_to(&list, nk::vec2f{0, 0});
+      nk::draw_list_path_clear(&list);
+    }
+    ~polyline_list() {
+      nk::buffer_free(&cmds);
+      nk::buffer_free(&vertices);
+      nk::buffer_free(&elements);
+    }
+    nk::vec2f
+    position(const unsigned int vertex) const {
+      nk::vec2f pos;
+      std::memcpy(&pos, (const std::uint8_t*) nk::buffer_memory_const(&vertices) + vertex * cfg.vertex_size, sizeof(pos));
+      return pos;
+    }
+  };
+}
+
+namespace {
+  std::vector<nk::vec2f>
+  straight_line() {
+    /* the first 4 segments go through the SIMD lanes, the others through the scalar tail. The line lies on
+     * y = 0 so the fringe vertices carry the normal without rounding against the point position */
+    std::vector<nk::vec2f> points;
+    for (int i = 0; i < 11; ++i)
+      points.push_back(nk::vec2f{3.0f * (float) i, 0.0f});
+    return points;
+  }
+}
+
+TEST_CASE("equal segments get equal fringes in SIMD lanes and the scalar tail", "[polyline]") {
+  polyline_list pl;
+  const std::vector<nk::vec2f> points = straight_line();
+  nk::draw_list_stroke_poly_line(&pl.list, points.data(), (unsigned int) points.size(), nk::color{255, 255, 255, 255},
+                                 nk::NK_STROKE_OPEN, 1.0f, nk::NK_ANTI_ALIASING_ON);
+  REQUIRE(pl.list.vertex_count == points.size() * 3);
+
+  /* every point writes itself followed by its two fringe vertices, the ends use the plain normal instead of a miter */
+  const float offset = pl.position(3 + 1).y;
+  CHECK(offset != 0.0f);
+  for (unsigned int i = 1; i + 1 < points.size(); ++i) {
+    CHECK(pl.position(i * 3 + 1).x == points[i].x);
+    CHECK(pl.position(i * 3 + 1).y == offset);
+    CHECK(pl.position(i * 3 + 2).y == -offset);
+  }
+}
+
+TEST_CASE("equal segments get equal thick edges in SIMD lanes and the scalar tail", "[polyline]") {
+  polyline_list pl;
+  const std::vector<nk::vec2f> points = straight_line();
+  nk::draw_list_stroke_poly_line(&pl.list, points.data(), (unsigned int) points.size(), nk::color{255, 255, 255, 255},
+                                 nk::NK_STROKE_OPEN, 3.0f, nk::NK_ANTI_ALIASING_ON);
+  REQUIRE(pl.list.vertex_count == points.size() * 4);
+
+  /* every point writes the outer fringe, both inner edges and the other outer fringe */
+  for (unsigned int i = 1; i + 1 < points.size(); ++i) {
+    for (unsigned int j = 0; j < 4; ++j) {
+      CHECK(pl.position(i * 4 + j).x == points[i].x);
+      CHECK(pl.position(i * 4 + j).y == pl.position(4 + j).y);
+    }
+    CHECK(pl.position(i * 4 + 0).y == -pl.position(i * 4 + 3).y);
+    CHECK(pl.position(i * 4 + 1).y == -pl.position(i * 4 + 2).y);
+  }
+}
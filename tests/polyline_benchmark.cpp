@@ -0,0 +1,75 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <vector>
+
+#include "scene.hpp"
+
+namespace {
+  struct polyline_bench {
+    nk::allocator heap = nk_test::heap();
+    nk::convert_config cfg = nk_test::convert_config();
+    nk::memory_buffer cmds, vertices, elements;
+    nk::draw_list list;
+    std::vector<nk::vec2f> line;
+    std::vector<nk::vec2f> circle;
+
+    explicit polyline_bench(const unsigned int count) {
+      nk::buffer_init(&cmds, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      nk::buffer_init(&vertices, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      nk::buffer_init(&elements, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      nk::draw_list_init(&list);
+      for (unsigned int i = 0; i < count; ++i) {
+        const float a = (float) i / (float) count * 6.2831853f;
+        line.push_back(nk::vec2f{(float) i * 0.25f, 100.0f + std::sin(a * 16.0f) * 50.0f});
+        circle.push_back(nk::vec2f{500.0f + std::cos(a) * 400.0f, 500.0f + std::sin(a) * 400.0f});
+      }
+    }
+    ~polyline_bench() {
+      nk::buffer_free(&cmds);
+      nk::buffer_free(&vertices);
+      nk::buffer_free(&elements);
+    }
+    void
+    reset() {
+      nk::buffer_clear(&cmds);
+      nk::buffer_clear(&vertices);
+      nk::buffer_clear(&elements);
+      nk::draw_list_setup(&list, &cfg, &cmds, &vertices, &elements, cfg.line_AA, cfg.shape_AA);
+      /* polylines append to the last command, the path api pushes the first one */
+      nk::draw_list_path_line_to(&list, nk::vec2f{0, 0});
+      nk::draw_list_path_clear(&list);
+    }
+  };
+
+  void
+  run(const unsigned int count) {
+    polyline_bench b(count);
+    const nk::color white = {255, 255, 255, 255};
+    BENCHMARK("stroke thin") {
+      b.reset();
+      nk::draw_list_stroke_poly_line(&b.list, b.line.data(), count, white, nk::NK_STROKE_OPEN, 1.0f, nk::NK_ANTI_ALIASING_ON);
+      return b.list.vertex_count;
+    };
+    BENCHMARK("stroke thick") {
+      b.reset();
+      nk::draw_list_stroke_poly_line(&b.list, b.line.data(), count, white, nk::NK_STROKE_OPEN, 3.0f, nk::NK_ANTI_ALIASING_ON);
+      return b.list.vertex_count;
+    };
+    BENCHMARK("fill convex") {
+      b.reset();
+      nk::draw_list_fill_poly_convex(&b.list, b.circle.data(), count, white, nk::NK_ANTI_ALIASING_ON);
+      return b.list.vertex_count;
+    };
+  }
+}
+
+TEST_CASE("polyline 1k points", "[benchmark][polyline]") {
+  run(1000);
+}
+TEST_CASE("polyline 10k points", "[benchmark][polyline]") {
+  run(10000);
+}
+TEST_CASE("polyline 100k points", "[benchmark][polyline]") {
+  run(100000);
+}
@@ -0,0 +1,135 @@
+#ifndef NK_POWER_TESTS_SCENE_HPP
+#define NK_POWER_TESTS_SCENE_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <nk/nuklear.hpp>
+
+/* shared fixtures of the tests and benchmarks: a fixed width font, a malloc
+ * backed allocator and a scene close to the overview demo */
+namespace nk_test {
+  inline float
+  font_width(nk::resource_handle, const float height, const char*, const int len) {
+    return (float) len * height * 0.5f;
+  }
+  inline nk::user_font
+  font() {
+    nk::user_font f{};
+    f.height = 13.0f;
+    f.width = font_width;
+    return f;
+  }
+
+  inline void*
+  heap_alloc(nk::resource_handle, void* old, const std::size_t size) {
+    return std::realloc(old, size);
+  }
+  inline void
+  heap_free(nk::resource_handle, void* ptr) {
+    std::free(ptr);
+  }
+  inline nk::allocator
+  heap() {
+    nk::allocator a{};
+    a.alloc = heap_alloc;
+    a.free = heap_free;
+    return a;
+  }
+
+  inline const nk::draw_vertex_layout_element vertex_layout[] = {
+      {nk::NK_VERTEX_POSITION, nk::NK_FORMAT_FLOAT, 0},
+      {nk::NK_VERTEX_TEXCOORD, nk::NK_FORMAT_FLOAT, 8},
+      {nk::NK_VERTEX_COLOR, nk::NK_FORMAT_R8G8B8A8, 16},
+      {nk::NK_VERTEX_ATTRIBUTE_COUNT, nk::NK_FORMAT_COUNT, 0}};
+
+  inline nk::convert_config
+  convert_config() {
+    nk::convert_config cfg{};
+    cfg.global_alpha = 1.0f;
+    cfg.line_AA = nk::NK_ANTI_ALIASING_ON;
+    cfg.shape_AA = nk::NK_ANTI_ALIASING_ON;
+    cfg.circle_segment_count = 22;
+    cfg.arc_segment_count = 22;
+    cfg.curve_segment_count = 22;
+    cfg.vertex_layout = vertex_layout;
+    cfg.vertex_size = 20;
+    cfg.vertex_alignment = alignof(float);
+    return cfg;
+  }
+
+  struct overview {
+    bool check = true;
+    bool popup = true;
+    float slider = 0.4f;
+    int property = 20;
+    int selected = 1;
+    std::size_t progress = 40;
+    char text[64] = "overview";
+    int text_len = 8;
+  };
+
+  /** one frame of input and widgets, `frame` moves the mouse so hover state changes */
+  inline void
+  overview_frame(nk::context* ctx, overview* s, const int frame) {
+    using namespace nk;
+    input_begin(ctx);
+    input_motion(ctx, 40 + frame % 200, 80 + frame % 120);
+    input_end(ctx);
+
+    const flag flags = panel_flags::WINDOW_BORDER | panel_flags::WINDOW_MOVABLE |
+                       panel_flags::WINDOW_SCALABLE | panel_flags::WINDOW_TITLE;
+    if (begin(ctx, "Overview", rect(10, 10, 400, 600), flags)) {
+      menubar_begin(ctx);
+      layout_row_static(ctx, 20, 60, 2);
+      if (menu_begin_label(ctx, "Menu", NK_TEXT_LEFT, vec2f{120, 200})) {
+        layout_row_dynamic(ctx, 20, 1);
+        menu_item_label(ctx, "Open", NK_TEXT_LEFT);
+        menu_end(ctx);
+      }
+      menubar_end(ctx);
+
+      layout_row_dynamic(ctx, 30, 2);
+      label(ctx, "Label", NK_TEXT_LEFT);
+      button_label(ctx, "Button");
+      checkbox_label(ctx, "Checkbox", &s->check);
+      slider_float(ctx, 0.0f, &s->slider, 1.0f, 0.1f);
+      property_int(ctx, "Property:", 0, &s->property, 100, 1, 1.0f);
+      progress(ctx, &s->progress, 100, true);
+
+      static const char* const items[] = {"Lines", "Columns", "Points"};
+      layout_row_dynamic(ctx, 25, 1);
+      s->selected = combo(ctx, items, 3, s->selected, 25, vec2f{200, 200});
+      edit_string(ctx, (flag) edit_types::EDIT_FIELD, s->text, &s->text_len, (int) sizeof(s->text), filter_default);
+
+      layout_row_dynamic(ctx, 100, 1);
+      if (chart_begin(ctx, chart_type::CHART_LINES, 32, -1.0f, 1.0f)) {
+        for (int i = 0; i < 32; ++i)
+          chart_push(ctx, (float) ((i + frame) % 16) / 8.0f - 1.0f);
+        chart_end(ctx);
+      }
+
+      layout_row_dynamic(ctx, 25, 1);
+      if (tree_push_hashed(ctx, tree_type::TREE_TAB, "Tree", collapse_states::MAXIMIZED, "overview", 8, 0)) {
+        for (int i = 0; i < 8; ++i)
+          selectable_label(ctx, "Item", NK_TEXT_LEFT, &s->check);
+        tree_pop(ctx);
+      }
+
+      if (s->popup && popup_begin(ctx, popup_type::POPUP_STATIC, "Popup", 0, rect(20, 100, 220, 90))) {
+        layout_row_dynamic(ctx, 25, 1);
+        label(ctx, "Popup", NK_TEXT_LEFT);
+        popup_end(ctx);
+      }
+    }
+    end(ctx);
+
+    if (begin(ctx, "Second", rect(300, 40, 200, 200), flags)) {
+      layout_row_dynamic(ctx, 25, 1);
+      for (int i = 0; i < 6; ++i)
+        button_label(ctx, "Button");
+    }
+    end(ctx);
+  }
+} // namespace nk_test
+
+#endif // NK_POWER_TESTS_SCENE_HPP
@@ -0,0 +1,76 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdio>
+
+#include "scene.hpp"
+
+namespace {
+  constexpr int frames = 256;
+
+  struct loopback {
+    nk::allocator heap = nk_test::heap();
+    nk::user_font font = nk_test::font();
+    nk::context ctx;
+    nk::stream_encoder enc;
+    nk::stream_decoder dec;
+    nk::capture_writer writer;
+    nk::memory_buffer message, capture, decoded;
+    nk_test::overview scene;
+    int frame = 0;
+
+    loopback() {
+      nk::init(&ctx, &heap, &font);
+      nk::stream_encoder_init(&enc, &heap);
+      nk::stream_decoder_init(&dec, &heap);
+      nk::capture_writer_init(&writer, &heap);
+      nk::buffer_init(&message, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      nk::buffer_init(&capture, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+      nk::buffer_init(&decoded, &heap, NK_BUFFER_DEFAULT_INITIAL_SIZE);
+    }
+    ~loopback() {
+      nk::buffer_free(&message);
+      nk::buffer_free(&capture);
+      nk::buffer_free(&decoded);
+      nk::capture_writer_free(&writer);
+      nk::stream_decoder_free(&dec);
+      nk::stream_encoder_free(&enc);
+      nk::free(&ctx);
+    }
+    /** encodes and decodes one frame, returns false if the decoder rejected it */
+    bool
+    step() {
+      nk_test::overview_frame(&ctx, &scene, frame++);
+      nk::buffer_clear(&message);
+      const bool ok = nk::stream_encode(&enc, &ctx, &message) &&
+                      nk::stream_decode(&dec, nk::buffer_memory_const(&message), message.allocated, 0, &decoded);
+      nk::clear(&ctx);
+      return ok;
+    }
+  };
+}
+
+TEST_CASE("stream loopback bandwidth", "[benchmark][stream]") {
+  loopback lo;
+  std::size_t streamed = 0, captured = 0;
+  for (int i = 0; i < frames; ++i) {
+    nk_test::overview_frame(&lo.ctx, &lo.scene, lo.frame++);
+    nk::buffer_clear(&lo.message);
+    nk::buffer_clear(&lo.capture);
+    REQUIRE(nk::stream_encode(&lo.enc, &lo.ctx, &lo.message));
+    REQUIRE(nk::capture_write(&lo.writer, &lo.ctx, &lo.capture));
+    REQUIRE(nk::stream_decode(&lo.dec, nk::buffer_memory_const(&lo.message), lo.message.allocated, 0, &lo.decoded));
+    streamed += lo.message.allocated;
+    captured += lo.capture.allocated;
+    nk::clear(&lo.ctx);
+  }
+  std::printf("stream loopback: %zu bytes per frame, full captures %zu bytes per frame\n",
+              streamed / frames, captured / frames);
+}
+
+TEST_CASE("stream loopback timing", "[benchmark][stream]") {
+  loopback lo;
+  REQUIRE(lo.step());
+  BENCHMARK("encode and decode one frame") {
+    return lo.step();
+  };
+}
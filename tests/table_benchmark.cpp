@@ -0,0 +1,51 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "scene.hpp"
+
+namespace {
+  struct tree_window {
+    nk::allocator heap = nk_test::heap();
+    nk::user_font font = nk_test::font();
+    nk::context ctx;
+
+    tree_window() {
+      nk::init(&ctx, &heap, &font);
+    }
+    ~tree_window() {
+      nk::free(&ctx);
+    }
+    /** one frame with `nodes` collapsed tree nodes, each looked up in the window's state table */
+    int
+    frame(const int nodes) {
+      using namespace nk;
+      int open = 0;
+      input_begin(&ctx);
+      input_end(&ctx);
+      if (begin(&ctx, "Tree", rect(0, 0, 400, 600), panel_flags::WINDOW_BORDER)) {
+        layout_row_dynamic(&ctx, 20, 1);
+        for (int i = 0; i < nodes; ++i) {
+          if (tree_push_hashed(&ctx, tree_type::TREE_NODE, "Node", collapse_states::MINIMIZED, "node", 4, i)) {
+            ++open;
+            tree_pop(&ctx);
+          }
+        }
+      }
+      end(&ctx);
+      nk::clear(&ctx);
+      return open;
+    }
+  };
+}
+
+TEST_CASE("tree state lookup with 10k nodes per window", "[benchmark][table]") {
+  tree_window tw;
+  /* the first frame inserts every node, the benchmarked frames only look them up */
+  REQUIRE(tw.frame(10000) == 0);
+  BENCHMARK("frame with 1k tree nodes") {
+    return tw.frame(1000);
+  };
+  BENCHMARK("frame with 10k tree nodes") {
+    return tw.frame(10000);
+  };
+}